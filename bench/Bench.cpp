@@ -0,0 +1,124 @@
+#include "Bench.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <vector>
+
+std::string Bench::nameFilter;
+std::string Bench::root;
+int Bench::samples = 15;
+volatile size_t Bench::sink = 0;
+std::ostream* Bench::output = &std::cout;
+
+namespace {
+
+#ifdef MIYOO
+const char* TARGET_NAME = "miyoo";
+#else
+const char* TARGET_NAME = "host";
+#endif
+
+} // namespace
+
+bool Bench::enabled(const std::string& name) {
+    return nameFilter.empty() || name.find(nameFilter) != std::string::npos;
+}
+
+void Bench::run(const std::string& name, size_t ops, const std::function<void()>& body,
+                const std::function<void()>& setup, const std::function<Fields()>& fields) {
+    if (!enabled(name)) return;
+    using Clock = std::chrono::steady_clock;
+
+    if (setup) setup();
+    body(); // Warm-up: page in code and data, fill caches
+
+    std::vector<double> perOp;
+    for (int i = 0; i < samples; ++i) {
+        if (setup) setup();
+        Clock::time_point start = Clock::now();
+        body();
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        perOp.push_back(ns / ops);
+    }
+    std::sort(perOp.begin(), perOp.end());
+    *output << "{\"bench\":\"" << name << "\",\"target\":\"" << TARGET_NAME << "\",\"ops\":" << ops
+              << ",\"samples\":" << samples << ",\"p50_ns\":" << static_cast<long long>(perOp[perOp.size() / 2])
+              << ",\"min_ns\":" << static_cast<long long>(perOp.front())
+              << ",\"max_ns\":" << static_cast<long long>(perOp.back());
+    if (fields) {
+        for (const auto& [key, value] : fields()) *output << ",\"" << key << "\":" << value;
+    }
+    *output << "}" << std::endl;
+}
+
+std::vector<Line> Bench::sampleLines(size_t count) {
+    static const char bullets[] = {'*', 'O', '-', '!', '?'};
+    std::vector<Line> lines(count);
+    for (size_t i = 0; i < count; ++i) {
+        lines[i].bulletType = bullets[i % sizeof(bullets)];
+        lines[i].completed = lines[i].bulletType == '*' && i % 3 == 0;
+        lines[i].content = "Line " + std::to_string(i) + ": follow up with the team about item " + std::to_string(i * 7 % 101);
+    }
+    return lines;
+}
+
+std::string Bench::sampleJournal(size_t count) {
+    static const char* words[] = {
+        "call", "mum", "about", "the", "weekend", "finish", "report", "for", "Monday", "buy", "milk",
+        "and", "bread", "meeting", "with", "Sam", "went", "well", "need", "to", "book", "dentist",
+        "idea:", "a", "small", "app", "that", "tracks", "plants", "read", "chapter", "4", "of",
+        "Dune", "tired", "today,", "slept", "badly", "gym", "at", "6pm", "pay", "rent", "by",
+        "Friday", "why", "does", "the", "build", "fail", "on", "ARM?", "fix", "bike", "tyre"};
+    static const char bullets[] = {'*', 'O', '-', '!', '?'};
+    const size_t wordCount = sizeof(words) / sizeof(words[0]);
+
+    // Deterministic, so sizes and ratios are comparable between runs
+    uint32_t seed = 12345;
+    auto next = [&]() {
+        seed = seed * 1103515245u + 12345u;
+        return seed >> 16;
+    };
+    std::vector<Line> lines(count);
+    for (Line& line : lines) {
+        line.bulletType = bullets[next() % sizeof(bullets)];
+        line.completed = line.bulletType == '*' && next() % 3 == 0;
+        size_t length = 3 + next() % 14;
+        for (size_t i = 0; i < length; ++i) {
+            if (i > 0) line.content += ' ';
+            line.content += words[next() % wordCount];
+        }
+    }
+    return NoteFormat::serialize(lines);
+}
+
+void Bench::skip(const std::string& name, const std::string& reason) {
+    if (!enabled(name)) return;
+    *output << "{\"bench\":\"" << name << "\",\"target\":\"" << TARGET_NAME << "\",\"skipped\":\"" << reason << "\"}" << std::endl;
+}
+
+// notepad_bench [--samples N] [name filter]
+int main(int argc, char* argv[]) {
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--samples") == 0 && i + 1 < argc) Bench::setSamples(std::max(1, std::atoi(argv[++i])));
+        else Bench::setFilter(argv[i]);
+    }
+    Bench::setRootDirectory(std::filesystem::current_path().string());
+    // The code under test logs to std::cout; stdout carries nothing but results
+    std::ostream results(std::cout.rdbuf());
+    std::cout.rdbuf(std::cerr.rdbuf());
+    Bench::setOutput(results);
+
+    benchHistory();
+    benchNoteFormat();
+    benchDictionary();
+    benchFuzzyFilter();
+    benchCompression();
+    benchFileSystem();
+    benchRendering();
+    std::cout.rdbuf(results.rdbuf());
+    return 0;
+}
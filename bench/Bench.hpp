@@ -0,0 +1,60 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../src/Utils/NoteFormat.hpp"
+
+// Harness for notepad_bench. A case is timed for a number of samples after one
+// warm-up run; each sample performs `ops` operations and is reported per
+// operation. Every result is a JSON line on stdout, so runs can be appended to
+// a file and compared over time.
+class Bench {
+public:
+    static void setFilter(const std::string& filter) { nameFilter = filter; }
+    static void setSamples(int count) { samples = count; }
+    static void setOutput(std::ostream& stream) { output = &stream; }
+    // Directory the bench was started from; assets are found relative to it
+    static void setRootDirectory(const std::string& path) { root = path; }
+    static const std::string& rootDirectory() { return root; }
+
+    // Extra numbers for a result line, e.g. sizes in and out
+    using Fields = std::vector<std::pair<std::string, double>>;
+
+    static bool enabled(const std::string& name);
+    // setup runs before every sample (and the warm-up) and is not timed;
+    // fields, if given, is called once after the samples
+    static void run(const std::string& name, size_t ops, const std::function<void()>& body,
+                    const std::function<void()>& setup = nullptr,
+                    const std::function<Fields()>& fields = nullptr);
+    static void skip(const std::string& name, const std::string& reason);
+
+    // A journal-like note: mixed bullets, some tasks done, typical line lengths
+    static std::vector<Line> sampleLines(size_t count);
+    // Closer to real writing for size-sensitive cases (compression, saves):
+    // varied words and line lengths, so it compresses like a journal does
+    static std::string sampleJournal(size_t lines);
+    // Line counts of a day's log, a month's and a year's
+    static constexpr size_t JOURNAL_SIZES[] = {30, 300, 3000};
+
+    // Keeps the optimizer from dropping a result nobody reads
+    static void keep(size_t value) { sink += value; }
+
+private:
+    static std::string nameFilter;
+    static std::string root;
+    static int samples;
+    static volatile size_t sink;
+    static std::ostream* output;
+};
+
+// One function per area, each in its own file
+void benchHistory();
+void benchNoteFormat();
+void benchDictionary();
+void benchFuzzyFilter();
+void benchCompression();
+void benchFileSystem();
+void benchRendering();
@@ -0,0 +1,24 @@
+#include "Bench.hpp"
+#include "../src/Utils/Compression.hpp"
+
+// Journals of a day, a month and a year; every result carries the sizes in and out
+void benchCompression() {
+    for (size_t lineCount : Bench::JOURNAL_SIZES) {
+        std::string content = Bench::sampleJournal(lineCount);
+        std::string frame = Compression::compress(content);
+        std::string kb = "." + std::to_string(content.size() / 1024) + "kb";
+        auto sizes = [&]() -> Bench::Fields {
+            return {{"raw_bytes", content.size()}, {"compressed_bytes", frame.size()},
+                    {"ratio", static_cast<double>(frame.size()) / content.size()}};
+        };
+
+        Bench::run("compression.compress" + kb, 1, [&]() {
+            Bench::keep(Compression::compress(content).size());
+        }, nullptr, sizes);
+        Bench::run("compression.decompress" + kb, 1, [&]() {
+            std::string output;
+            Compression::decompress(frame, output);
+            Bench::keep(output.size());
+        }, nullptr, sizes);
+    }
+}
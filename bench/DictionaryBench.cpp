@@ -0,0 +1,59 @@
+#include "Bench.hpp"
+#include "../src/InputEngine.hpp"
+#include "../src/Utils/Dictionary.hpp"
+#include "../src/Utils/FontManager.hpp"
+#include "../src/Utils/TextRasterizer.hpp"
+#include <SDL2/SDL.h>
+
+namespace {
+
+void press(InputEngine& engine, SDL_Keycode key) {
+    SDL_Event event;
+    SDL_memset(&event, 0, sizeof(event));
+    event.type = SDL_KEYDOWN;
+    event.key.keysym.sym = key;
+    engine.handleEvent(event);
+}
+
+} // namespace
+
+void benchDictionary() {
+    Bench::run("dictionary.build", 1, []() {
+        Bench::keep(Dictionary::build()->size());
+    });
+
+    // There is no lookup: the crank draws from the whole word list, and every
+    // frame walks all of it to find the few words on screen. A frame as the
+    // editor runs it, on SDL's software renderer, at the first word and at the
+    // last one (Up from the first wraps round).
+    if (!Bench::enabled("dictionary.crank.")) return;
+    SDL_Surface* target = SDL_CreateRGBSurfaceWithFormat(0, 640, 480, 32, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Renderer* renderer = target ? SDL_CreateSoftwareRenderer(target) : nullptr;
+    if (!renderer) {
+        Bench::skip("dictionary.crank.", "no software renderer");
+        if (target) SDL_FreeSurface(target);
+        return;
+    }
+
+    FontManager fonts;
+    fonts.load(Bench::rootDirectory() + "/assets/fonts/");
+    TextRasterizer rasterizer(fonts);
+    InputEngine engine(rasterizer);
+    engine.setDictionary(Dictionary::build());
+    engine.setLerpStrength(1.0f); // Settled: no scrolling between samples
+    press(engine, SDLK_LSHIFT);   // SELECT: focus the crank
+    auto frame = [&]() {
+        rasterizer.beginFrame(renderer);
+        engine.update();
+        engine.render(renderer);
+    };
+
+    Bench::run("dictionary.crank.first_word", 1, frame);
+    press(engine, SDLK_UP);
+    Bench::run("dictionary.crank.last_word", 1, frame);
+
+    rasterizer.close();
+    fonts.close();
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(target);
+}
@@ -0,0 +1,63 @@
+#include "Bench.hpp"
+#include "../src/Utils/FileSystem.hpp"
+#include <filesystem>
+#include <unistd.h>
+
+// Durable saves (temp file, fsync, rename), reads and privatizing, in a scratch
+// directory so real notes are never touched. Numbers include the fsyncs, so
+// they say as much about the card as about the code.
+void benchFileSystem() {
+    if (!Bench::enabled("fs.")) return;
+    namespace fs = std::filesystem;
+    fs::path scratch = fs::temp_directory_path() / ("notepad_bench_" + std::to_string(getpid()));
+    fs::create_directories(scratch);
+    fs::current_path(scratch);
+    FileSystem::init();
+
+    const std::string note = "bench.txt";
+    FileSystem::unlockVault("bench");
+    for (size_t lineCount : Bench::JOURNAL_SIZES) {
+        std::string content = Bench::sampleJournal(lineCount);
+        std::string kb = "." + std::to_string(content.size() / 1024) + "kb";
+        // What the note takes on the card, against its plain text
+        auto onDisk = [&](const std::string& path) {
+            return [&content, path]() -> Bench::Fields {
+                std::error_code ec;
+                double bytes = static_cast<double>(fs::file_size(path, ec));
+                return {{"raw_bytes", content.size()}, {"disk_bytes", bytes}, {"ratio", bytes / content.size()}};
+            };
+        };
+
+        for (bool compressed : {false, true}) {
+            FileSystem::setCompression(compressed);
+            std::string variant = compressed ? ".compressed" : "";
+            Bench::run("fs.save" + variant + kb, 1, [&]() {
+                FileSystem::saveFile(note, content, false);
+            }, nullptr, onDisk(FileSystem::publicDirectory() + note));
+            Bench::run("fs.read" + variant + kb, 1, [&]() {
+                Bench::keep(FileSystem::readFile(note, false).size());
+            });
+        }
+        FileSystem::setCompression(false);
+
+        Bench::run("fs.save.vault" + kb, 1, [&]() {
+            FileSystem::saveFile(note, content, true);
+        }, nullptr, onDisk(FileSystem::vaultDirectory() + note));
+        Bench::run("fs.read.vault" + kb, 1, [&]() {
+            Bench::keep(FileSystem::readFile(note, true).size());
+        });
+
+        int privatized = 0;
+        std::string source;
+        Bench::run("fs.privatize" + kb, 1, [&]() {
+            Bench::keep(FileSystem::privatizeFile(source));
+        }, [&]() {
+            source = "private" + std::to_string(privatized++) + ".txt";
+            FileSystem::saveFile(source, content, false);
+        });
+    }
+    FileSystem::lockVault();
+
+    fs::current_path(Bench::rootDirectory());
+    fs::remove_all(scratch);
+}
@@ -0,0 +1,30 @@
+#include "Bench.hpp"
+#include "../src/Utils/FuzzyFilter.hpp"
+
+// The browser's Find: each typed character re-ranks the previous results.
+// The target is a keystroke within one frame for 10,000 notes.
+void benchFuzzyFilter() {
+    for (int count : {2000, 10000}) {
+        std::vector<std::string> names;
+        for (int i = 0; i < count; ++i) {
+            names.push_back("2024-" + std::to_string(1 + i % 12) + "-" + std::to_string(1 + i % 28) + " meeting notes " + std::to_string(i) + ".txt");
+        }
+        FuzzyFilter filter;
+        filter.setCandidates(names);
+        const std::string query = "mtng12";
+        const std::string suffix = "." + std::to_string(count) + "_notes";
+
+        Bench::run("fuzzy.type" + suffix, query.size(), [&]() {
+            for (char c : query) filter.push(c);
+            Bench::keep(filter.results().size());
+        }, [&]() { filter.clear(); });
+
+        Bench::run("fuzzy.backspace" + suffix, query.size(), [&]() {
+            for (size_t i = 0; i < query.size(); ++i) filter.pop();
+            Bench::keep(filter.results().size());
+        }, [&]() {
+            filter.clear();
+            for (char c : query) filter.push(c);
+        });
+    }
+}
@@ -0,0 +1,33 @@
+#include "Bench.hpp"
+#include "../src/Utils/HistoryManager.hpp"
+
+// The editor pushes a full copy of the document after every edit, so push and
+// undo cost scales with note length
+void benchHistory() {
+    const size_t EDITS = 100; // A full history
+
+    for (size_t size : {1000, 10000}) {
+        std::string suffix = "." + std::to_string(size) + "_lines";
+        std::vector<Line> document = Bench::sampleLines(size);
+        HistoryManager<std::vector<Line>> history;
+
+        Bench::run("history.push" + suffix, EDITS, [&]() {
+            for (size_t i = 0; i < EDITS; ++i) {
+                document[i * 7 % size].content += "x";
+                history.push(document);
+            }
+        }, [&]() { history.clear(); });
+
+        Bench::run("history.undo" + suffix, EDITS, [&]() {
+            std::vector<Line> current = document;
+            for (size_t i = 0; i < EDITS; ++i) current = history.undo(current);
+            Bench::keep(current.size());
+        }, [&]() {
+            history.clear();
+            for (size_t i = 0; i < EDITS; ++i) {
+                document[i * 7 % size].content += "y";
+                history.push(document);
+            }
+        });
+    }
+}
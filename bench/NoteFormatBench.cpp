@@ -0,0 +1,14 @@
+#include "Bench.hpp"
+
+// Every open and save goes through these
+void benchNoteFormat() {
+    std::vector<Line> lines = Bench::sampleLines(10000);
+    std::string content = NoteFormat::serialize(lines);
+
+    Bench::run("noteformat.parse.10000_lines", 1, [&]() {
+        Bench::keep(NoteFormat::parse(content).size());
+    });
+    Bench::run("noteformat.serialize.10000_lines", 1, [&]() {
+        Bench::keep(NoteFormat::serialize(lines).size());
+    });
+}
@@ -0,0 +1,102 @@
+#include "Bench.hpp"
+#include "../src/InputEngine.hpp"
+#include "../src/Utils/BakedFont.hpp"
+#include "../src/Utils/Dictionary.hpp"
+#include "../src/Utils/FontManager.hpp"
+#include "../src/Utils/TextRasterizer.hpp"
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+
+namespace {
+
+void drawScreen(SDL_Renderer* renderer, const std::vector<Line>& lines, const std::function<SDL_Surface*(const std::string&)>& rasterize) {
+    int y = 60;
+    for (const Line& line : lines) {
+        SDL_Surface* surface = rasterize(line.content);
+        if (!surface) continue;
+        SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+        SDL_Rect dst = {40, y, surface->w, surface->h};
+        SDL_RenderCopy(renderer, texture, NULL, &dst);
+        SDL_DestroyTexture(texture);
+        SDL_FreeSurface(surface);
+        y += 30;
+    }
+}
+
+} // namespace
+
+// Text drawing as the states do it (rasterize, upload, copy, destroy per call),
+// from the baked atlas and through SDL_ttf, on SDL's software renderer so
+// results don't depend on a display or GPU
+void benchRendering() {
+    if (!Bench::enabled("render.")) return;
+    SDL_Surface* target = SDL_CreateRGBSurfaceWithFormat(0, 640, 480, 32, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Renderer* renderer = target ? SDL_CreateSoftwareRenderer(target) : nullptr;
+    if (!renderer) {
+        Bench::skip("render.", "no software renderer");
+        if (target) SDL_FreeSurface(target);
+        return;
+    }
+
+    const std::string directory = Bench::rootDirectory() + "/assets/fonts/";
+    const SDL_Color white = {255, 255, 255, 255};
+    const std::vector<Line> lines = Bench::sampleLines(11); // One editor screen
+
+    BakedFont baked;
+    const BakedFont::Face* face = baked.load(directory + "baked.npf") ? baked.find("default", 20) : nullptr;
+    if (face) {
+        Bench::run("render.font.load_baked", 1, [&]() {
+            BakedFont font;
+            Bench::keep(font.load(directory + "baked.npf"));
+        });
+        Bench::run("render.text.baked_editor_screen", lines.size(), [&]() {
+            drawScreen(renderer, lines, [&](const std::string& text) { return face->render(text, white); });
+        });
+    } else {
+        Bench::skip("render.font.load_baked", "assets/fonts/baked.npf not found (make fonts)");
+    }
+
+    if (TTF_Init() == -1) {
+        Bench::skip("render.", "TTF_Init failed");
+        SDL_DestroyRenderer(renderer);
+        SDL_FreeSurface(target);
+        return;
+    }
+    TTF_Font* font = TTF_OpenFont((directory + "default.ttf").c_str(), 20);
+    if (font) {
+        Bench::run("render.font.open_ttf", 1, [&]() {
+            TTF_Font* opened = TTF_OpenFont((directory + "default.ttf").c_str(), 20);
+            if (opened) TTF_CloseFont(opened);
+        });
+        Bench::run("render.text.editor_screen", lines.size(), [&]() {
+            drawScreen(renderer, lines, [&](const std::string& text) { return TTF_RenderText_Blended(font, text.c_str(), white); });
+        });
+        // A size that wasn't baked, filled in the first time it is drawn with
+        Bench::run("render.font.bake_size", BakedFont::GLYPH_COUNT, [&]() {
+            BakedFont::Face unbaked = BakedFont::Face::empty("default", 20, font);
+            for (unsigned char c = BakedFont::FIRST_GLYPH; c <= BakedFont::LAST_GLYPH; ++c) unbaked.bake(font, c);
+            Bench::keep(unbaked.atlasHeight);
+        });
+        TTF_CloseFont(font);
+    } else {
+        Bench::skip("render.text.editor_screen", "assets/fonts/default.ttf not found");
+    }
+
+    // As the app draws it: cached textures, baked glyphs where possible, no worker
+    FontManager fonts;
+    fonts.load(directory);
+    TextRasterizer rasterizer(fonts);
+    InputEngine engine(rasterizer);
+    engine.setDictionary(Dictionary::build());
+    Bench::run("render.input_engine", 1, [&]() {
+        rasterizer.beginFrame(renderer);
+        engine.update();
+        engine.render(renderer);
+    });
+    rasterizer.close();
+    fonts.close();
+
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(target);
+    TTF_Quit();
+}
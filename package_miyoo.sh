@@ -16,6 +16,8 @@ rm -rf dist
 if command -v arm-linux-gnueabihf-g++ &> /dev/null; then
     echo "🛠  Compiling with arm-linux-gnueabihf-g++..."
     make miyoo
+    # The baker runs on this machine and needs its SDL2_ttf; without it the app opens the TTF at startup
+    make fonts || echo "⚠️  Could not bake fonts, text will be drawn with SDL_ttf."
 else
     echo "⚠️  Cross-compiler not found! Building generic host binary instead for testing."
     echo "   (To build for device, ensure arm-linux-gnueabihf-g++ is in your PATH)"
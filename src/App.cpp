@@ -1,68 +1,466 @@
 #include "App.hpp"
 #include "States/BrowserState.hpp"
 #include "States/DecoyState.hpp"
+#include "States/EditorState.hpp"
+#include "States/CanvasState.hpp"
+#include "States/PassphraseState.hpp"
 #include "Utils/FileSystem.hpp"
+#include "Utils/Trace.hpp"
 #include <iostream>
+#include <algorithm>
+#include <csignal>
 
 App::App() {
     settings.load();
+    startupProfile.mark("settings");
 }
 
 App::~App() {
+    // Snapshot first, so the next launch comes back here. Then let the current
+    // state queue its final save, and drain the I/O queue. States below it
+    // were suspended (and saved) when they were covered.
+    captureSession();
+    if (printsDiagnostics()) {
+        for (const auto& cache : caches.caches()) {
+            std::cout << "Cache " << cache.name << ": " << cache.cost() / 1024 << "KB" << std::endl;
+        }
+        for (const auto& [pair, stats] : transitionStats) {
+            std::cout << "Transition " << pair << ": n=" << stats.count
+                      << " avg=" << stats.totalMs / stats.count << "ms max=" << stats.maxMs << "ms" << std::endl;
+        }
+        for (const auto& [state, bytes] : peakStateMemory) {
+            std::cout << "Memory " << state << ": peak=" << bytes / 1024 << "KB" << std::endl;
+        }
+    }
+    if (currentState) currentState->exit(*this);
+    currentState.reset();
+    stateStack.clear();
+    statePool.clear();
+    decoys.clear(); // Their textures go before the renderer
+    perfHud.release();
+    textRasterizer.close();
+    fonts.close();
+
+    listingCache.cancelPreviews();
+    ioWorker.stop();
+    telemetry.stop();
+
+    listingCache.save();
     settings.save();
-    if (font) TTF_CloseFont(font);
+#ifdef NOTEPAD_TRACING
+    if (Trace::dump(TRACE_PATH)) std::cout << "Trace written to " << TRACE_PATH << std::endl;
+#endif
     if (renderer) SDL_DestroyRenderer(renderer);
     if (window) SDL_DestroyWindow(window);
-    TTF_Quit();
     SDL_Quit();
 }
 
 bool App::init() {
+#if defined(NOTEPAD_TRACING) && defined(SIGUSR1)
+    // kill -USR1 <pid> over ssh dumps the trace so far
+    std::signal(SIGUSR1, [](int) { traceDumpRequested = 1; });
+#endif
+    if (headless) SDL_setenv("SDL_VIDEODRIVER", "dummy", 0);
     if (SDL_Init(SDL_INIT_VIDEO) < 0) return false;
-    if (TTF_Init() == -1) return false;
+    startupProfile.mark("sdl");
 
     window = SDL_CreateWindow("Miyoo Notes", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, SCREEN_WIDTH, SCREEN_HEIGHT, SDL_WINDOW_SHOWN);
     if (!window) return false;
 
-    renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+    Uint32 rendererFlags = headless ? SDL_RENDERER_SOFTWARE : SDL_RENDERER_ACCELERATED;
+    if (!maxSpeed) rendererFlags |= SDL_RENDERER_PRESENTVSYNC;
+    renderer = SDL_CreateRenderer(window, -1, rendererFlags);
     if (!renderer) return false;
+    SDL_DisplayMode mode;
+    if (SDL_GetWindowDisplayMode(window, &mode) == 0 && mode.refresh_rate > 0) frameIntervalMs = 1000.0f / mode.refresh_rate;
+    startupProfile.mark("window");
 
-    // Load Font
-    font = TTF_OpenFont("assets/fonts/default.ttf", 20);
-    if (!font) font = TTF_OpenFont("../assets/fonts/default.ttf", 20); // Try relative
-    if (!font) {
+    // Fonts: the baked sizes now; SDL_ttf and other sizes are only opened when something is drawn with them
+    if (!fonts.load("assets/fonts/") && !fonts.load("../assets/fonts/")) { // Try relative
         std::cerr << "Failed to load font!" << std::endl;
         return false;
     }
+    if (!fonts.hasBaked()) std::cerr << "No baked fonts (make fonts), drawing all text with SDL_ttf" << std::endl;
+    // Strings outside ASCII are rasterized on the second core; without it they are drawn inline
+    if (!textRasterizer.start()) std::cerr << "Text worker unavailable, rasterizing inline" << std::endl;
+    startupProfile.mark("font");
+
+    if (!replayPath.empty()) {
+        if (!replay.load(replayPath)) {
+            std::cerr << "Failed to load replay " << replayPath << std::endl;
+            return false;
+        }
+        replaying = true;
+    }
+    if (!recordPath.empty() && !recorder.open(recordPath)) {
+        std::cerr << "Failed to open " << recordPath << " for recording" << std::endl;
+        return false;
+    }
 
     FileSystem::init();
+    FileSystem::setCompression(settings.compressNotes);
+
+    ioWorker.setSaveListener([this](const std::string& filename, const std::string& content, bool isVault) {
+        if (isVault) return; // The manifest carries vault previews
+        std::vector<Line> lines = NoteFormat::parse(content);
+        std::time_t modified = FileSystem::modifiedTime(filename, false);
+        taskIndex.updateNote(filename, lines, modified);
+        taskIndex.save();
+        listingCache.updatePreview(filename, lines, content, modified);
+    });
+    ioWorker.start();
+    telemetry.start();
 
-    // Start in Browser State
-    changeState(std::make_shared<BrowserState>());
+    // Everything that walks a directory or builds big tables runs on the worker,
+    // in this order and ahead of any save. The browser shows "Loading" until the
+    // listing is in; the editor's crank uses its defaults until the dictionary is.
+    submitStartupJob("stale temps", []() { FileSystem::removeStaleTemps(); });
+    submitStartupJob("listing", [this]() { listingCache.load(); },
+                     [this]() { listingCache.refreshPreviewsAsync(ioWorker); });
+    submitStartupJob("task index", [this]() { taskIndex.load(listingCache); });
+    auto words = std::make_shared<Dictionary::Words>();
+    submitStartupJob("dictionary", [words]() { *words = Dictionary::build(); },
+                     [this, words]() { dictionary = *words; });
+
+    // Created now so a panic always has a decoy; their text is rasterized after the first frame
+    for (int mode = 0; mode < AppSettings::DECOY_SCREEN_COUNT; ++mode) {
+        decoys.push_back(std::make_shared<DecoyState>(mode));
+    }
+    registerCaches();
+    startupProfile.mark("services");
+
+    // Back to where the last run left off, or start in Browser State. Recordings
+    // and replays always start in the browser so they begin from the same screen.
+    bool inputSession = replaying || recorder.isOpen();
+    if (!inputSession && restoreSession()) {
+        startupProfile.mark("session");
+    } else {
+        changeState(pooledState<BrowserState>());
+        startupProfile.mark("browser");
+    }
 
     return true;
 }
 
+bool App::printsDiagnostics() const {
+#ifdef NOTEPAD_TRACING
+    return true;
+#else
+    return benchStartup || measureLatency || replaying || caches.simulatedLevel() != MemoryPressure::NONE;
+#endif
+}
+
+void App::submitStartupJob(const std::string& phase, std::function<void()> job, std::function<void()> done) {
+    pendingStartupJobs++;
+    ioWorker.submit([this, phase, job]() {
+        Uint64 start = SDL_GetPerformanceCounter();
+        job();
+        startupProfile.addDeferred(phase, (SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency());
+    }, [this, done]() {
+        if (done) done();
+        pendingStartupJobs--;
+    });
+}
+
+void App::captureSession() {
+    // A replay must not replace the session the user comes back to
+    if (!currentState || replaying) return;
+    SnapshotWriter navigation;
+    navigation.str(currentState->name());
+    session.put(SessionSection::NAVIGATION, std::move(navigation.data));
+    currentState->saveSession(*this, session);
+    session.flush(ioWorker);
+    lastSessionCapture = SDL_GetTicks();
+}
+
+bool App::restoreSession() {
+    session.load();
+    // Drawings come back whatever was on top; the canvas is pooled anyway
+    auto canvas = pooledState<CanvasState>();
+    bool canvasRestored = canvas->restoreSession(*this, session);
+
+    const std::string* navigation = session.get(SessionSection::NAVIGATION);
+    if (!navigation) return false;
+    SnapshotReader in(*navigation);
+    std::string top = in.str();
+
+    // Only states with something to lose are worth coming back to. Not the
+    // decoy either: after a panic the next launch is a plain one.
+    std::shared_ptr<State> state;
+    if (top == "Editor") {
+        auto editor = pooledState<EditorState>();
+        if (editor->restoreSession(*this, session)) state = editor;
+    } else if (top == "Canvas" && canvasRestored) {
+        state = canvas;
+    }
+    if (!state) return false;
+
+    // The browser sits underneath, entered only if Back reaches it
+    beginTransition(nullptr, state);
+    stateStack.push_back(pooledState<BrowserState>());
+    stateStack.push_back(state);
+    currentState = state;
+    activate(state);
+    std::cout << "Restored session: " << state->name() << std::endl;
+    return true;
+}
+
+// Right after the first present: startup work that needs the renderer but not the first frame
+void App::finishStartup() {
+    Uint64 start = SDL_GetPerformanceCounter();
+    for (auto& decoy : decoys) {
+        std::static_pointer_cast<DecoyState>(decoy)->prerender(renderer, textRasterizer);
+    }
+    startupProfile.addDeferred("decoys", (SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency());
+}
+
 void App::changeState(std::shared_ptr<State> newState) {
-    if (currentState) currentState->exit(*this);
+    beginTransition(currentState, newState);
+    if (currentState) {
+        deactivate(currentState);
+        stateStack.pop_back();
+    }
+    stateStack.push_back(newState);
     currentState = newState;
-    if (currentState) currentState->enter(*this);
+    activate(newState);
+}
+
+void App::pushState(std::shared_ptr<State> state) {
+    // Already underneath: unwind back down to it instead of stacking it twice
+    if (std::find(stateStack.begin(), stateStack.end(), state) != stateStack.end()) {
+        while (currentState != state) popState();
+        return;
+    }
+
+    beginTransition(currentState, state);
+    if (currentState) currentState->suspend(*this);
+    stateStack.push_back(state);
+    currentState = state;
+    activate(state);
+}
+
+void App::popState() {
+    if (stateStack.size() <= 1) {
+        changeState(pooledState<BrowserState>());
+        return;
+    }
+
+    std::shared_ptr<State> below = stateStack[stateStack.size() - 2];
+    beginTransition(currentState, below);
+    deactivate(currentState);
+    stateStack.pop_back();
+    currentState = below;
+    currentState->resume(*this); // Stacked states were suspended by pushState
+}
+
+void App::panic(Uint32 comboTimestamp) {
+    int index = std::clamp(settings.decoyScreenIndex, 0, (int)decoys.size() - 1);
+    std::shared_ptr<State> decoy = decoys[index];
+    if (currentState == decoy) return; // Combo still held (key repeat)
+
+    // Present the decoy before anything else runs. Leaving the covered states
+    // (the editor queues its save) happens after the screen has changed.
+    std::vector<std::shared_ptr<State>> covered;
+    covered.swap(stateStack);
+    beginTransition(currentState, decoy);
+    stateStack.push_back(decoy);
+    currentState = decoy;
+    panicPending = true;
+    panicComboTimestamp = comboTimestamp;
+    activate(decoy);
+    decoy->render(*this, renderer);
+    SDL_RenderPresent(renderer);
+    decoyPresented(true);
+    inputsPresented();
+    endTransition();
+
+    // Only the top was active; the ones below were already suspended
+    if (!covered.empty()) deactivate(covered.back());
+    captureSession(); // The next launch must not reopen what was on screen
+}
+
+void App::trimStates() {
+    for (auto& [type, state] : statePool) {
+        if (state && std::find(stateStack.begin(), stateStack.end(), state) == stateStack.end()) {
+            state->trim(*this);
+        }
+    }
+}
+
+std::vector<State*> App::liveStates() const {
+    std::vector<State*> live;
+    for (auto it = stateStack.rbegin(); it != stateStack.rend(); ++it) live.push_back(it->get());
+    for (State* state : enteredStates) {
+        if (std::find(live.begin(), live.end(), state) == live.end()) live.push_back(state);
+    }
+    return live;
+}
+
+void App::checkStateMemory() {
+    lastMemoryCheck = SDL_GetTicks();
+    std::vector<StateMemory> usage;
+    for (State* state : liveStates()) {
+        size_t bytes = state->memoryUsage();
+        size_t budget = state->memoryBudget();
+        while (budget > 0 && bytes > budget && state->shedMemory(*this)) bytes = state->memoryUsage();
+        if (bytes == 0) continue;
+        size_t& peak = peakStateMemory[state->name()];
+        peak = std::max(peak, bytes);
+        usage.push_back({state->name(), bytes, budget});
+    }
+    telemetry.recordStateMemory(std::move(usage));
+}
+
+void App::registerCaches() {
+    // Cheapest to rebuild first: text is redrawn as it is needed, glyphs of unbaked sizes are re-baked,
+    // documents are only a re-read away
+    caches.add("text textures", 0, MemoryPressure::LOW,
+               [this]() { return textRasterizer.memoryUsage(); },
+               [this](MemoryPressure level) {
+                   size_t bytes = textRasterizer.memoryUsage();
+                   textRasterizer.clear();
+                   return bytes;
+               });
+    caches.add("font sizes", 0, MemoryPressure::LOW,
+               [this]() { return fonts.memoryUsage(); },
+               [this](MemoryPressure level) { return fonts.evict(); });
+    caches.add("documents", 1, MemoryPressure::LOW,
+               [this]() { return documentCache.memoryUsage(); },
+               [this](MemoryPressure level) {
+                   return documentCache.shrinkTo(level == MemoryPressure::LOW ? documentCache.memoryUsage() / 2 : 0);
+               });
+    // Suspended states: ribbons and other rebuildables, then their undo history
+    caches.add("suspended states", 2, MemoryPressure::LOW,
+               [this]() {
+                   size_t bytes = 0;
+                   for (State* state : liveStates()) if (state != currentState.get()) bytes += state->memoryUsage();
+                   return bytes;
+               },
+               [this](MemoryPressure level) {
+                   trimStates();
+                   size_t released = 0;
+                   for (State* state : liveStates()) {
+                       if (state == currentState.get()) continue;
+                       size_t before = state->memoryUsage();
+                       if (state->shedMemory(*this)) released += before - std::min(before, state->memoryUsage());
+                   }
+                   return released;
+               });
+    // The open note's undo history is only given up when the OOM killer is close
+    caches.add("undo history", 3, MemoryPressure::CRITICAL,
+               [this]() { return currentState ? currentState->memoryUsage() : 0; },
+               [this](MemoryPressure level) -> size_t {
+                   if (!currentState) return 0;
+                   size_t before = currentState->memoryUsage();
+                   if (!currentState->shedMemory(*this)) return 0;
+                   return before - std::min(before, currentState->memoryUsage());
+               });
+    // Counted, not evicted: rebuilding them means reading every note again
+    caches.add("listing", 10, MemoryPressure::CRITICAL, [this]() { return listingCache.memoryUsage(); });
+    caches.add("task index", 11, MemoryPressure::CRITICAL, [this]() { return taskIndex.memoryUsage(); });
+    caches.add("dictionary", 12, MemoryPressure::CRITICAL, [this]() {
+        size_t bytes = 0;
+        if (dictionary) {
+            bytes = dictionary->capacity() * sizeof(std::string);
+            for (const std::string& word : *dictionary) bytes += word.capacity();
+        }
+        return bytes;
+    });
+}
+
+void App::checkMemoryPressure() {
+    SystemSample sample = telemetry.latest();
+    MemoryPressure level = caches.simulatedLevel();
+    if (level == MemoryPressure::NONE) level = CacheRegistry::levelOf(sample, memoryPressure);
+    if (level != memoryPressure) {
+        std::cout << "Memory pressure: " << CacheRegistry::nameOf(level) << " (" << sample.memAvailableKB / 1024
+                  << "MB available, stall " << sample.memoryStallPercent << "%)" << std::endl;
+        memoryPressure = level;
+    }
+    // Checked every second while it lasts, each time only as far up the
+    // priorities as the shortfall needs
+    caches.evict(level, CacheRegistry::shortfallOf(sample), SDL_GetTicks());
+}
+
+bool App::isPooled(const std::shared_ptr<State>& state) const {
+    for (const auto& [type, pooled] : statePool) {
+        if (pooled == state) return true;
+    }
+    return false;
 }
 
-void App::checkGlobalInput(const SDL_Event& event) {
+void App::activate(const std::shared_ptr<State>& state) {
+    if (!state) return;
+    if (!isPooled(state)) {
+        state->enter(*this);
+        return;
+    }
+    if (std::find(enteredStates.begin(), enteredStates.end(), state.get()) != enteredStates.end()) {
+        state->resume(*this);
+    } else {
+        enteredStates.push_back(state.get());
+        state->enter(*this);
+    }
+}
+
+void App::deactivate(const std::shared_ptr<State>& state) {
+    if (isPooled(state)) state->suspend(*this);
+    else state->exit(*this);
+}
+
+void App::beginTransition(const std::shared_ptr<State>& from, const std::shared_ptr<State>& to) {
+    pendingTransition = std::string(from ? from->name() : "Start") + "->" + (to ? to->name() : "None");
+    transitionStart = SDL_GetPerformanceCounter();
+}
+
+void App::endTransition() {
+    if (pendingTransition.empty()) return;
+    double ms = (SDL_GetPerformanceCounter() - transitionStart) * 1000.0 / SDL_GetPerformanceFrequency();
+    TransitionStats& stats = transitionStats[pendingTransition];
+    stats.count++;
+    stats.totalMs += ms;
+    stats.maxMs = std::max(stats.maxMs, ms);
+    pendingTransition.clear();
+}
+
+void App::unlockVault(const std::string& passphrase, std::function<void(bool)> done) {
+    // Key derivation and manifest loading hit the card; keep them off the UI thread
+    ioWorker.run<bool>([passphrase]() { return FileSystem::unlockVault(passphrase); },
+                       [this, done](const bool& unlocked) {
+                           vaultUnlocked = unlocked;
+                           std::cout << "Vault Unlocked: " << vaultUnlocked << std::endl;
+                           if (done) done(unlocked);
+                           refreshBrowser();
+                       });
+}
+
+void App::lockVault() {
+    vaultUnlocked = false;
+    std::cout << "Vault Unlocked: " << vaultUnlocked << std::endl;
+    documentCache.removeVault();
+    ioWorker.submit([]() { FileSystem::lockVault(); }, [this]() { refreshBrowser(); });
+}
+
+void App::refreshBrowser() {
+    // Force refresh current state if it's browser
+    // A better way is to use an event bus, but here we can just re-list the browser
+    if (auto browser = std::dynamic_pointer_cast<BrowserState>(currentState)) {
+        browser->refreshList(*this);
+    }
+}
+
+bool App::checkGlobalInput(const SDL_Event& event) {
+    bool consumed = false;
     if (event.type == SDL_KEYDOWN) {
         // Konami Code
         if (event.key.keysym.sym == konamiCode[konamiIndex]) {
             konamiIndex++;
             if (konamiIndex >= konamiCode.size()) {
-                vaultUnlocked = !vaultUnlocked; // Toggle
                 konamiIndex = 0;
-                std::cout << "Vault Unlocked: " << vaultUnlocked << std::endl;
-                // Force refresh current state if it's browser
-                // A better way is to use an event bus, but here we can just reload browser
-                if (std::dynamic_pointer_cast<BrowserState>(currentState)) {
-                    changeState(std::make_shared<BrowserState>());
-                }
+                // The gesture only asks for the passphrase; the key comes from what is typed there
+                if (vaultUnlocked) lockVault();
+                else if (!std::dynamic_pointer_cast<PassphraseState>(currentState)) pushState(std::make_shared<PassphraseState>());
+                consumed = true; // The final key must not also act on the screen below
             }
         } else {
             konamiIndex = 0;
@@ -72,31 +470,210 @@ void App::checkGlobalInput(const SDL_Event& event) {
         // This is hard to detect simultaneously with just KeyDown unless we track state.
         // For simplicity, we use a specific panic key for dev: 'P' or verify modifiers.
         // Let's implement robust modifier check.
-        const Uint8* state = SDL_GetKeyboardState(NULL);
+        const Uint8* state = getKeyboardState();
         // Assuming mapping: L2=k, R2=l, SELECT=LSHIFT, START=RETURN
         if (state[SDL_SCANCODE_K] && state[SDL_SCANCODE_L] && 
             (state[SDL_SCANCODE_LSHIFT] || state[SDL_SCANCODE_RSHIFT]) && 
             state[SDL_SCANCODE_RETURN]) {
-            changeState(std::make_shared<DecoyState>(settings.decoyScreenIndex));
+            panic(event.key.timestamp);
         }
     }
+    return consumed;
 }
 
 void App::run() {
+    TRACE_THREAD("main");
     SDL_Event e;
+    Uint64 lastPresent = SDL_GetPerformanceCounter();
+    Uint64 lastPoll = lastPresent;
+    double toMs = 1000.0 / SDL_GetPerformanceFrequency();
     while (running) {
-        while (SDL_PollEvent(&e) != 0) {
-            if (e.type == SDL_QUIT) running = false;
-            
-            checkGlobalInput(e);
-            if (currentState) currentState->handleEvent(*this, e);
+        TRACE_SCOPE("frame");
+        Uint64 frameStart = SDL_GetPerformanceCounter();
+        {
+            TRACE_SCOPE("events");
+            size_t inputsBefore = unpresentedInputs.size();
+            while (SDL_PollEvent(&e) != 0) {
+                // A replay owns the keyboard; quit and worker completions still get through
+                if (replaying && (e.type == SDL_KEYDOWN || e.type == SDL_KEYUP)) continue;
+                // Keys pressed while startup is still loading replay as soon as it is done
+                if (recorder.isOpen()) recorder.record(inputSessionFrame, inputSessionMs(), e);
+                dispatchEvent(e);
+            }
+            if (replaying && inputSessionStarted) injectReplayEvents();
+            if (measureLatency) {
+                if (unpresentedInputs.size() > inputsBefore) pollGapMs.push_back(static_cast<float>((frameStart - lastPoll) * toMs));
+                lastPoll = frameStart;
+            }
+        }
+
+        textRasterizer.beginFrame(renderer);
+        if (currentState) {
+            TRACE_SCOPE_CAT("update", currentState->name());
+            currentState->update(*this);
+        }
+
+        if (currentState) {
+            TRACE_SCOPE_CAT("render", currentState->name());
+            currentState->render(*this, renderer);
+        }
+        Uint64 workEnd = SDL_GetPerformanceCounter();
+        if (replaying && inputSessionStarted && currentState) {
+            replayWorkMs[currentState->name()].push_back(static_cast<float>((workEnd - frameStart) * toMs));
+        }
+        if (settings.showPerfHud) perfHud.render(renderer, textRasterizer, telemetry);
+        {
+            TRACE_SCOPE("present");
+            SDL_RenderPresent(renderer);
+        }
+        decoyPresented(false);
+        inputsPresented();
+        Uint64 presented = SDL_GetPerformanceCounter();
+        telemetry.recordFrame(static_cast<float>((presented - lastPresent) * toMs), static_cast<float>((workEnd - frameStart) * toMs));
+        lastPresent = presented;
+        endTransition();
+#ifdef NOTEPAD_TRACING
+        if (traceDumpRequested) {
+            traceDumpRequested = 0;
+            dumpTrace();
+        }
+#endif
+
+        if (SDL_GetTicks() - lastSessionCapture >= SESSION_INTERVAL_MS) captureSession();
+        if (SDL_GetTicks() - lastMemoryCheck >= MEMORY_CHECK_INTERVAL_MS) {
+            checkStateMemory();
+            if (startupReported) checkMemoryPressure(); // The indices are loading until then
         }
 
-        if (currentState) currentState->update(*this);
+        if (!startupProfile.hasPresented()) {
+            startupProfile.firstPresent();
+            finishStartup();
+        } else if (!startupReported && pendingStartupJobs == 0) {
+            startupReported = true;
+            startupProfile.report();
+            if (benchStartup) {
+                std::cout << startupProfile.toJson() << std::endl;
+                running = false;
+            }
+            inputSessionStarted = true;
+            inputSessionStart = SDL_GetTicks();
+        } else if (inputSessionStarted) {
+            // At max speed a frame can be far shorter than the load it waits on,
+            // so replayed frames only count once the worker has caught up
+            if (!(replaying && maxSpeed && ioWorker.isBusy())) inputSessionFrame++;
+            if (replaying && replay.finished() && !ioWorker.isBusy() && ++replayDrainFrames > REPLAY_DRAIN_FRAMES) {
+                running = false;
+            }
+        }
 
-        if (currentState) currentState->render(*this, renderer);
-        SDL_RenderPresent(renderer);
-        
+        if (maxSpeed) continue;
+        TRACE_SCOPE("sleep");
+        waitForNextFrame(presented);
+    }
+    recorder.close();
+    if (replaying) reportReplay();
+    if (measureLatency) reportLatency();
+    if (replaying || measureLatency) reportPanics();
+}
+
+void App::waitForNextFrame(Uint64 presented) {
+    if (!settings.lateInput) {
         SDL_Delay(16);
+        return;
+    }
+    // The slowest recent frames set the budget, so a spike rarely misses the vblank
+    double sincePresent = (SDL_GetPerformanceCounter() - presented) * 1000.0 / SDL_GetPerformanceFrequency();
+    double sleepMs = frameIntervalMs - telemetry.workStats().p99 - LATE_INPUT_MARGIN_MS - sincePresent;
+    if (sleepMs >= 1.0) SDL_Delay(static_cast<Uint32>(sleepMs));
+}
+
+void App::inputsPresented() {
+    if (unpresentedInputs.empty()) return;
+    Uint32 now = SDL_GetTicks();
+    for (Uint32 timestamp : unpresentedInputs) inputLatencyMs.push_back(static_cast<float>(now - timestamp));
+    unpresentedInputs.clear();
+}
+
+void App::decoyPresented(bool immediate) {
+    if (!panicPending || std::find(decoys.begin(), decoys.end(), currentState) == decoys.end()) return;
+    panicPending = false;
+    panicLatencyMs.push_back(static_cast<float>(SDL_GetTicks() - panicComboTimestamp));
+    if (!immediate) deferredPanics++;
+}
+
+void App::dispatchEvent(const SDL_Event& e) {
+    if (e.type == SDL_QUIT) running = false;
+    if (measureLatency && e.type == SDL_KEYDOWN) unpresentedInputs.push_back(e.key.timestamp);
+    if (ioWorker.handleEvent(e)) return;
+
+    if (checkGlobalInput(e)) return;
+    if (currentState) {
+        TRACE_SCOPE_CAT("handleEvent", currentState->name());
+        currentState->handleEvent(*this, e);
+    }
+}
+
+const Uint8* App::getKeyboardState() const {
+    return replaying ? replayKeys : SDL_GetKeyboardState(NULL);
+}
+
+uint32_t App::inputSessionMs() const {
+    return inputSessionStarted ? SDL_GetTicks() - inputSessionStart : 0;
+}
+
+void App::injectReplayEvents() {
+    for (SDL_Event& e : replay.takeDue(inputSessionFrame, inputSessionMs(), maxSpeed)) {
+        // Stamped as if it had just arrived, so latency measurements stay meaningful
+        e.common.timestamp = SDL_GetTicks();
+        if (e.type == SDL_KEYDOWN || e.type == SDL_KEYUP) {
+            SDL_Scancode scancode = e.key.keysym.scancode;
+            if (scancode >= 0 && scancode < SDL_NUM_SCANCODES) replayKeys[scancode] = e.type == SDL_KEYDOWN;
+        }
+        dispatchEvent(e);
+    }
+}
+
+// ,"p50_ms":..,"p90_ms":..,"p99_ms":..,"max_ms":.. for a report line
+static std::string percentilesJson(std::vector<float> samples, const std::string& prefix = "") {
+    if (samples.empty()) return "";
+    std::sort(samples.begin(), samples.end());
+    size_t n = samples.size();
+    std::string json;
+    for (size_t percent : {50, 90, 99}) {
+        json += ",\"" + prefix + "p" + std::to_string(percent) + "_ms\":" + std::to_string(samples[std::min(n - 1, n * percent / 100)]);
+    }
+    return json + ",\"" + prefix + "max_ms\":" + std::to_string(samples.back());
+}
+
+void App::reportReplay() const {
+    // One JSON line per state: work (event, update, render) time per frame, excluding present and sleep
+    for (const auto& [state, samples] : replayWorkMs) {
+        std::cout << "{\"replay\":\"" << replayPath << "\",\"state\":\"" << state << "\",\"frames\":" << samples.size()
+                  << percentilesJson(samples) << ",\"max_speed\":" << (maxSpeed ? "true" : "false") << "}" << std::endl;
     }
 }
+
+void App::reportLatency() const {
+    // Key press (as SDL saw it) to the end of the present showing it, ms resolution
+    std::cout << "{\"input_latency\":" << inputLatencyMs.size() << percentilesJson(inputLatencyMs)
+              << percentilesJson(pollGapMs, "poll_gap_") << ",\"late_input\":" << (settings.lateInput ? "true" : "false")
+              << ",\"frame_interval_ms\":" << frameIntervalMs << "}" << std::endl;
+}
+
+void App::reportPanics() const {
+    if (panicLatencyMs.empty()) return;
+    // Combo key press (as SDL saw it) to the present showing the decoy
+    std::cout << "{\"panic\":" << panicLatencyMs.size() << ",\"deferred\":" << deferredPanics
+              << percentilesJson(panicLatencyMs) << "}" << std::endl;
+}
+
+#ifdef NOTEPAD_TRACING
+volatile std::sig_atomic_t App::traceDumpRequested = 0;
+
+void App::dumpTrace() {
+    // Formatting and writing a few MB shouldn't stall a frame
+    ioWorker.submit([]() {
+        if (Trace::dump(TRACE_PATH)) std::cout << "Trace written to " << TRACE_PATH << std::endl;
+    });
+}
+#endif
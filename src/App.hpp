@@ -3,9 +3,24 @@
 #include <SDL2/SDL_ttf.h>
 #include <memory>
 #include <vector>
+#include <map>
+#include <typeindex>
 #include <iostream>
+#include <csignal>
 #include "State.hpp"
 #include "Utils/AppSettings.hpp"
+#include "Utils/TaskIndex.hpp"
+#include "Utils/IOWorker.hpp"
+#include "Utils/ListingCache.hpp"
+#include "Utils/DocumentCache.hpp"
+#include "Utils/StartupProfiler.hpp"
+#include "Utils/Dictionary.hpp"
+#include "Utils/SessionSnapshot.hpp"
+#include "Utils/Telemetry.hpp"
+#include "Utils/CacheRegistry.hpp"
+#include "Utils/TextRasterizer.hpp"
+#include "Utils/InputRecording.hpp"
+#include "PerfHud.hpp"
 
 class App {
 public:
@@ -14,29 +29,185 @@ public:
 
     bool init();
     void run();
-    void changeState(std::shared_ptr<State> newState);
+    // --bench-startup: quit once startup (including deferred work) is done and print its timings as JSON
+    void setStartupBenchmark(bool enabled) { benchStartup = enabled; }
+    // Input sessions: --record <file> writes the keys pressed, --replay <file> plays them back
+    // and prints per-state frame times. --max-speed drops vsync and the frame sleep (replays
+    // then pace by frame count), --headless renders in software to SDL's dummy video driver.
+    void setRecordPath(const std::string& path) { recordPath = path; }
+    void setReplayPath(const std::string& path) { replayPath = path; }
+    void setMaxSpeed(bool enabled) { maxSpeed = enabled; }
+    void setHeadless(bool enabled) { headless = enabled; }
+    // --simulate-pressure low|critical: evict as if free memory were that scarce
+    void simulateMemoryPressure(MemoryPressure level) { caches.simulate(level); }
+    // --latency: time every key press to the present that shows it, print the distribution at exit
+    void setLatencyMeasurement(bool enabled) { measureLatency = enabled; }
+
+    // Navigation. States live on a stack; the top one is current.
+    void changeState(std::shared_ptr<State> newState); // Replace the top
+    void pushState(std::shared_ptr<State> state);      // Suspend the top, show state over it
+    void popState();                                   // Back: leave the top (to the Browser if it was the last)
+    void panic(Uint32 comboTimestamp);                 // Show the decoy now, leave everything after
+
+    // One long-lived instance per state type, suspended between visits
+    template <typename T>
+    std::shared_ptr<T> pooledState() {
+        std::shared_ptr<State>& slot = statePool[std::type_index(typeid(T))];
+        if (!slot) slot = std::make_shared<T>();
+        return std::static_pointer_cast<T>(slot);
+    }
+    // Memory pressure: suspended pooled states release what they can rebuild
+    void trimStates();
+    // Caches register here to be evicted under memory pressure
+    CacheRegistry& getCacheRegistry() { return caches; }
+    // Bytes each state reported at its largest, for the exit report
+    const std::map<std::string, size_t>& getPeakStateMemory() const { return peakStateMemory; }
+    // Combo to decoy on screen, per panic; deferred ones waited for the frame's own present
+    const std::vector<float>& getPanicLatency() const { return panicLatencyMs; }
+    int getDeferredPanics() const { return deferredPanics; }
+
+    // False once the main loop has ended: the last session capture, at quit, is under way
+    bool isRunning() const { return running; }
+
+    // Time from a transition starting to the first frame presented after it
+    struct TransitionStats {
+        int count = 0;
+        double totalMs = 0.0;
+        double maxMs = 0.0;
+    };
+    const std::map<std::string, TransitionStats>& getTransitionStats() const { return transitionStats; }
     
     // Accessors
     SDL_Renderer* getRenderer() const { return renderer; }
-    TTF_Font* getFont() const { return font; }
+    TextRasterizer& getTextRasterizer() { return textRasterizer; }
+    FontManager& getFonts() { return fonts; }
     int getScreenWidth() const { return SCREEN_WIDTH; }
     int getScreenHeight() const { return SCREEN_HEIGHT; }
     AppSettings& getSettings() { return settings; }
+    TaskIndex& getTaskIndex() { return taskIndex; }
+    IOWorker& getIOWorker() { return ioWorker; }
+    ListingCache& getListingCache() { return listingCache; }
+    DocumentCache& getDocumentCache() { return documentCache; }
+    SessionSnapshot& getSession() { return session; }
+    const Telemetry& getTelemetry() const { return telemetry; }
+    const StartupProfiler& getStartupProfile() const { return startupProfile; }
+    // Null until the background build after startup has finished
+    Dictionary::Words getDictionary() const { return dictionary; }
 
-    // Global Input Handling (Konami, Panic)
-    void checkGlobalInput(const SDL_Event& event);
+    // Global Input Handling (Konami, Panic). True if the event was used up.
+    bool checkGlobalInput(const SDL_Event& event);
+    // Use instead of SDL_GetKeyboardState: during a replay the held keys are the replayed ones
+    const Uint8* getKeyboardState() const;
     bool isVaultUnlocked() const { return vaultUnlocked; }
+    // On the IOWorker; done(false) if the passphrase doesn't open the vault
+    void unlockVault(const std::string& passphrase, std::function<void(bool)> done);
+    void lockVault();
 
 private:
+    StartupProfiler startupProfile; // First member: its clock starts before anything else
+    bool benchStartup = false;
+    int pendingStartupJobs = 0; // Background startup jobs still running
+    bool startupReported = false;
+    void submitStartupJob(const std::string& phase, std::function<void()> job, std::function<void()> done = nullptr);
+    void finishStartup();
+
     const int SCREEN_WIDTH = 640;
     const int SCREEN_HEIGHT = 480;
 
     SDL_Window* window = nullptr;
     SDL_Renderer* renderer = nullptr;
-    TTF_Font* font = nullptr;
 
     bool running = true;
-    std::shared_ptr<State> currentState;
+    std::shared_ptr<State> currentState; // Always stateStack.back()
+    std::vector<std::shared_ptr<State>> stateStack;
+    std::map<std::type_index, std::shared_ptr<State>> statePool;
+    std::vector<State*> enteredStates; // Pooled states that have had their enter()
+    std::vector<std::shared_ptr<State>> decoys; // One per decoyScreenIndex, pre-rendered right after the first frame
+    Dictionary::Words dictionary;
+
+    std::map<std::string, TransitionStats> transitionStats;
+    std::string pendingTransition;
+    Uint64 transitionStart = 0;
+
+    // Per-state memory accounting and budgets
+    static constexpr Uint32 MEMORY_CHECK_INTERVAL_MS = 1000;
+    Uint32 lastMemoryCheck = 0;
+    std::map<std::string, size_t> peakStateMemory;
+    MemoryPressure memoryPressure = MemoryPressure::NONE;
+    void checkStateMemory();
+    void checkMemoryPressure();
+    void registerCaches();
+    std::vector<State*> liveStates() const; // Stack top first, then suspended pooled states
+
+    bool isPooled(const std::shared_ptr<State>& state) const;
+    void activate(const std::shared_ptr<State>& state);
+    void deactivate(const std::shared_ptr<State>& state);
+    void beginTransition(const std::shared_ptr<State>& from, const std::shared_ptr<State>& to);
+    void endTransition();
+
+    // Session snapshot: written every SESSION_INTERVAL_MS, restored at launch
+    static constexpr Uint32 SESSION_INTERVAL_MS = 2000;
+    Uint32 lastSessionCapture = 0;
+    void captureSession();
+    bool restoreSession(); // False: nothing to restore, start in the browser
+
+    // Input sessions. The session starts when startup (background loads included)
+    // is done; recorded frames and times count from there.
+    static constexpr int REPLAY_DRAIN_FRAMES = 30; // Frames kept after the last event
+    std::string recordPath;
+    std::string replayPath;
+    bool maxSpeed = false;
+    bool headless = false;
+    bool replaying = false;
+    InputRecorder recorder;
+    InputReplay replay;
+    bool inputSessionStarted = false;
+    Uint32 inputSessionStart = 0;
+    uint32_t inputSessionFrame = 0;
+    int replayDrainFrames = 0;
+    Uint8 replayKeys[SDL_NUM_SCANCODES] = {};
+    std::map<std::string, std::vector<float>> replayWorkMs; // Per state, one entry per frame
+    uint32_t inputSessionMs() const;
+    void injectReplayEvents();
+    void reportReplay() const;
+
+    void dispatchEvent(const SDL_Event& event);
+
+    // Frame pacing. Late input sleeps until just enough of the frame is left for
+    // the usual work, so buttons are read right before the frame that shows them.
+    static constexpr float LATE_INPUT_MARGIN_MS = 2.0f;
+    float frameIntervalMs = 1000.0f / 60; // From the display's refresh rate
+    void waitForNextFrame(Uint64 presented);
+
+    // Input latency. SDL stamps an event when it reads it from the driver, which
+    // is during the poll, so the wait before the poll is reported as the gap
+    // between polls (an upper bound) rather than measured.
+    bool measureLatency = false;
+    std::vector<Uint32> unpresentedInputs; // Timestamps of key presses handled since the last present
+    std::vector<float> inputLatencyMs;
+    std::vector<float> pollGapMs;
+    void inputsPresented();
+    void reportLatency() const;
+
+    // Panic timing, reported by --replay and --latency runs. A panic must be on
+    // screen before the next event is handled, not at the end of the frame.
+    bool panicPending = false;
+    Uint32 panicComboTimestamp = 0;
+    std::vector<float> panicLatencyMs;
+    int deferredPanics = 0;
+    void decoyPresented(bool immediate);
+    void reportPanics() const;
+
+    // Transition, memory and cache figures are only printed at exit when a
+    // measuring run asked for them (bench, latency, replay, trace or simulated pressure)
+    bool printsDiagnostics() const;
+
+#ifdef NOTEPAD_TRACING
+    // Chrome trace of the session: written on SIGUSR1 and at exit
+    static constexpr const char* TRACE_PATH = "trace.json";
+    static volatile std::sig_atomic_t traceDumpRequested;
+    void dumpTrace();
+#endif
 
     // Konami Code Logic
     std::vector<SDL_Keycode> konamiCode = {
@@ -46,6 +217,17 @@ private:
     };
     size_t konamiIndex = 0;
     bool vaultUnlocked = false;
+    void refreshBrowser();
 
     AppSettings settings;
+    TaskIndex taskIndex;
+    ListingCache listingCache;
+    DocumentCache documentCache;
+    SessionSnapshot session;
+    Telemetry telemetry;
+    CacheRegistry caches;
+    PerfHud perfHud;
+    FontManager fonts;
+    TextRasterizer textRasterizer{fonts};
+    IOWorker ioWorker;
 };
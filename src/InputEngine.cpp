@@ -1,18 +1,20 @@
 #include "InputEngine.hpp"
+#include "Utils/Trace.hpp"
 #include <iostream>
 
-InputEngine::InputEngine(TTF_Font* font) : font(font) {
+InputEngine::InputEngine(TextRasterizer& textRasterizer) : textRasterizer(textRasterizer) {
     // Initialize predictions with some dummy data
-    predictions = {"HELLO", "WORLD", "MIYOO", "MINI", "PLUS", "LINUX", "SDL2", "CODE", "RETRO", "GAMING"};
+    predictions = std::make_shared<const std::vector<std::string>>(std::vector<std::string>{
+        "HELLO", "WORLD", "MIYOO", "MINI", "PLUS", "LINUX", "SDL2", "CODE", "RETRO", "GAMING"});
     updatePredictions();
 }
 
 InputEngine::~InputEngine() {
 }
 
-void InputEngine::setDictionary(const std::vector<std::string>& words) {
-    predictions = words;
-    if (predictions.empty()) predictions.push_back("...");
+void InputEngine::setDictionary(Dictionary::Words words) {
+    if (!words || words->empty()) words = std::make_shared<const std::vector<std::string>>(1, "...");
+    predictions = std::move(words);
     crankIndex = 0;
 }
 
@@ -48,14 +50,14 @@ bool InputEngine::handleEvent(const SDL_Event& event) {
             case SDLK_UP:
                 if (currentFocus == Focus::CRANK) {
                     crankIndex--;
-                    if (crankIndex < 0) crankIndex = predictions.size() - 1;
+                    if (crankIndex < 0) crankIndex = predictions->size() - 1;
                     handled = true;
                 }
                 break;
             case SDLK_DOWN:
                 if (currentFocus == Focus::CRANK) {
                     crankIndex++;
-                    if (crankIndex >= predictions.size()) crankIndex = 0;
+                    if (crankIndex >= predictions->size()) crankIndex = 0;
                     handled = true;
                 }
                 break;
@@ -80,8 +82,8 @@ bool InputEngine::handleEvent(const SDL_Event& event) {
                 if (currentFocus == Focus::RIBBON) {
                     inputBuffer += qwerty[ribbonIndex];
                 } else {
-                    if (!predictions.empty()) {
-                        inputBuffer += predictions[crankIndex] + " ";
+                    if (!predictions->empty()) {
+                        inputBuffer += (*predictions)[crankIndex] + " ";
                     }
                 }
                 handled = true;
@@ -89,6 +91,7 @@ bool InputEngine::handleEvent(const SDL_Event& event) {
 
             case SDLK_RSHIFT: // SELECT
             case SDLK_LSHIFT:
+                if (!crankEnabled) break;
                 currentFocus = (currentFocus == Focus::RIBBON) ? Focus::CRANK : Focus::RIBBON;
                 handled = true;
                 break;
@@ -118,6 +121,11 @@ void InputEngine::setKeyboardLayout(bool alphabetical) {
     }
 }
 
+void InputEngine::setCrankEnabled(bool enabled) {
+    crankEnabled = enabled;
+    if (!enabled) currentFocus = Focus::RIBBON;
+}
+
 void InputEngine::updatePhysics() {
     // VisualPos+=(TargetPos−VisualPos)×lerpStrength
     ribbonVisualPos += (ribbonTargetPos - ribbonVisualPos) * lerpStrength;
@@ -125,6 +133,7 @@ void InputEngine::updatePhysics() {
 }
 
 void InputEngine::render(SDL_Renderer* renderer) {
+    TRACE_SCOPE("InputEngine::render");
     // Do NOT clear background here, allowing overlays
     // Render Ribbon (Horizontal)
     int startY = RIBBON_Y;
@@ -151,6 +160,8 @@ void InputEngine::render(SDL_Renderer* renderer) {
         renderText(renderer, s, static_cast<int>(x) + 10, startY + 5, col);
     }
 
+    if (!crankEnabled) return;
+
     // Render Crank (Vertical) on Right
     int crankX = CRANK_X;
     
@@ -161,24 +172,20 @@ void InputEngine::render(SDL_Renderer* renderer) {
         SDL_RenderFillRect(renderer, &selRect);
     }
 
-    for (size_t i = 0; i < predictions.size(); ++i) {
+    for (size_t i = 0; i < predictions->size(); ++i) {
         float y = crankVisualPos + (i * WORD_HEIGHT);
         if (y < -WORD_HEIGHT || y > SCREEN_HEIGHT) continue;
 
-        SDL_Color col = {150, 150, 150, 255};
-        if (i == crankIndex) col = {255, 255, 255, 255};
-
-        renderText(renderer, predictions[i], crankX, static_cast<int>(y), col);
+        // The selected word at full size, the others smaller around it
+        if (i == crankIndex) {
+            renderText(renderer, (*predictions)[i], crankX, static_cast<int>(y), {255, 255, 255, 255});
+        } else {
+            int offset = (FontManager::BODY.size - FontManager::SMALL.size) / 2;
+            renderText(renderer, (*predictions)[i], crankX, static_cast<int>(y) + offset, {150, 150, 150, 255}, FontManager::SMALL);
+        }
     }
 }
 
-void InputEngine::renderText(SDL_Renderer* renderer, const std::string& text, int x, int y, SDL_Color color) {
-    if (text.empty()) return;
-    SDL_Surface* surface = TTF_RenderText_Blended(font, text.c_str(), color);
-    if (!surface) return;
-    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-    SDL_Rect dstRect = {x, y, surface->w, surface->h};
-    SDL_RenderCopy(renderer, texture, NULL, &dstRect);
-    SDL_DestroyTexture(texture);
-    SDL_FreeSurface(surface);
+void InputEngine::renderText(SDL_Renderer* renderer, const std::string& text, int x, int y, SDL_Color color, Font font) {
+    textRasterizer.draw(renderer, font, text, color, x, y);
 }
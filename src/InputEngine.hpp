@@ -1,15 +1,18 @@
 #pragma once
 
 #include <SDL2/SDL.h>
-#include <SDL2/SDL_ttf.h>
 #include <string>
 #include <vector>
 #include <cmath>
 #include <functional>
+#include <memory>
+#include "Utils/Dictionary.hpp"
+#include "Utils/TextRasterizer.hpp"
 
 class InputEngine {
 public:
-    InputEngine(TTF_Font* font);
+    // Text is drawn through the rasterizer (cached, baked glyphs or off-thread)
+    InputEngine(TextRasterizer& textRasterizer);
     ~InputEngine();
 
     // Returns true if input was generated
@@ -21,12 +24,14 @@ public:
     std::string popInput();
     bool hasInput() const { return !inputBuffer.empty(); }
 
-    // Set dictionary for predictions
-    void setDictionary(const std::vector<std::string>& words);
+    // Set dictionary for predictions (shared, never copied)
+    void setDictionary(Dictionary::Words words);
 
     // Configuration
     void setLerpStrength(float strength) { lerpStrength = strength; }
     void setKeyboardLayout(bool alphabetical);
+    // Ribbon-only mode (e.g. the browser's filter): hides the prediction crank
+    void setCrankEnabled(bool enabled);
 
 private:
     static constexpr int SCREEN_WIDTH = 640;
@@ -36,13 +41,14 @@ private:
     static constexpr int RIBBON_Y = 400;
     static constexpr int CRANK_X = 540;
 
-    TTF_Font* font;
+    TextRasterizer& textRasterizer;
     
     // Settings
     float lerpStrength = 0.22f;
     std::string qwerty = "QWERTYUIOPASDFGHJKLZXCVBNM "; 
-    std::vector<std::string> predictions;
+    Dictionary::Words predictions;
     std::string inputBuffer; // Accumulates characters to be popped by Editor
+    bool crankEnabled = true;
 
     // State
     enum class Focus {
@@ -63,7 +69,7 @@ private:
 
     // Helper methods
     void updatePhysics();
-    void renderText(SDL_Renderer* renderer, const std::string& text, int x, int y, SDL_Color color);
+    void renderText(SDL_Renderer* renderer, const std::string& text, int x, int y, SDL_Color color, Font font = FontManager::BODY);
     
     void updatePredictions();
 };
@@ -0,0 +1,122 @@
+#include "PerfHud.hpp"
+#include <algorithm>
+#include <cstdio>
+
+PerfHud::~PerfHud() {
+    release();
+}
+
+void PerfHud::release() {
+    for (auto& line : lines) {
+        if (line.texture) {
+            SDL_DestroyTexture(line.texture);
+            Telemetry::textureDestroyed();
+        }
+    }
+    lines.clear();
+}
+
+void PerfHud::render(SDL_Renderer* renderer, TextRasterizer& rasterizer, const Telemetry& telemetry) {
+    Uint32 now = SDL_GetTicks();
+    if (lines.empty() || now - lastRefresh >= TEXT_REFRESH_MS) {
+        std::vector<std::string> text = describe(telemetry);
+        if (lines.size() < text.size()) lines.resize(text.size());
+        for (size_t i = 0; i < text.size(); ++i) setLine(renderer, rasterizer, i, text[i]);
+        lastRefresh = now;
+    }
+
+    SDL_BlendMode previousBlend;
+    SDL_GetRenderDrawBlendMode(renderer, &previousBlend);
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+
+    int height = static_cast<int>(lines.size()) * LINE_HEIGHT + GRAPH_HEIGHT + 12;
+    SDL_Rect panel = {X, Y, WIDTH, height};
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 180);
+    SDL_RenderFillRect(renderer, &panel);
+
+    int y = Y + 4;
+    for (const auto& line : lines) {
+        if (line.texture) {
+            SDL_Rect dst = {X + 6, y, line.w, line.h};
+            SDL_RenderCopy(renderer, line.texture, NULL, &dst);
+        }
+        y += LINE_HEIGHT;
+    }
+    renderGraph(renderer, telemetry, y + 4);
+
+    SDL_SetRenderDrawBlendMode(renderer, previousBlend);
+}
+
+std::vector<std::string> PerfHud::describe(const Telemetry& telemetry) {
+    char buffer[96];
+    std::vector<std::string> text;
+
+    FrameStats frame = telemetry.frameStats();
+    FrameStats work = telemetry.workStats();
+    std::snprintf(buffer, sizeof(buffer), "FRAME p50 %.1f p99 %.1f ms", frame.p50, frame.p99);
+    text.push_back(buffer);
+    std::snprintf(buffer, sizeof(buffer), "WORK  p50 %.1f p99 %.1f max %.1f", work.p50, work.p99, work.max);
+    text.push_back(buffer);
+
+    // Creations since the last refresh; the text helpers make one per string drawn
+    unsigned long created = Telemetry::texturesCreated();
+    float perSecond = (created - lastCreatedTextures) * 1000.0f / TEXT_REFRESH_MS;
+    lastCreatedTextures = created;
+    std::snprintf(buffer, sizeof(buffer), "TEX %d live, %.0f new/s", Telemetry::textureCount(), perSecond);
+    text.push_back(buffer);
+
+    if (!telemetry.stateMemory().empty()) {
+        const StateMemory& state = telemetry.stateMemory().front();
+        std::snprintf(buffer, sizeof(buffer), "MEM %s %.1f/%.0fMB", state.state.c_str(),
+                      state.bytes / 1048576.0, state.budget / 1048576.0);
+        text.push_back(buffer);
+    }
+
+    SystemSample sample = telemetry.latest();
+    std::snprintf(buffer, sizeof(buffer), "RSS %ldMB  FREE %ld/%ldMB",
+                  sample.rssKB / 1024, sample.memAvailableKB / 1024, sample.memTotalKB / 1024);
+    text.push_back(buffer);
+    std::string battery = sample.batteryPercent >= 0 ? std::to_string(sample.batteryPercent) + "%" : "--";
+    std::string cpu = sample.cpuFreqMHz >= 0 ? std::to_string(sample.cpuFreqMHz) + "MHz" : "--";
+    text.push_back("BAT " + battery + "  CPU " + cpu);
+    return text;
+}
+
+void PerfHud::setLine(SDL_Renderer* renderer, TextRasterizer& rasterizer, size_t index, const std::string& text) {
+    TextLine& line = lines[index];
+    if (line.texture && line.text == text) return;
+    if (line.texture) {
+        SDL_DestroyTexture(line.texture);
+        Telemetry::textureDestroyed();
+        line.texture = nullptr;
+    }
+    line.text = text;
+
+    SDL_Surface* surface = rasterizer.render(FontManager::TINY, text, {200, 255, 200, 255});
+    if (!surface) return;
+    line.texture = SDL_CreateTextureFromSurface(renderer, surface);
+    if (line.texture) Telemetry::textureCreated();
+    line.w = surface->w;
+    line.h = surface->h;
+    SDL_FreeSurface(surface);
+}
+
+void PerfHud::renderGraph(SDL_Renderer* renderer, const Telemetry& telemetry, int top) {
+    int bottom = top + GRAPH_HEIGHT;
+    std::vector<float> frames = telemetry.frameTimes();
+
+    // One column per frame, newest on the right; red past a 60 fps frame
+    int x = X + WIDTH - 8;
+    for (auto it = frames.rbegin(); it != frames.rend() && x > X + 6; ++it, --x) {
+        float ms = std::min(*it, GRAPH_MAX_MS);
+        int h = static_cast<int>(ms / GRAPH_MAX_MS * GRAPH_HEIGHT);
+        if (*it > 17.0f) SDL_SetRenderDrawColor(renderer, 255, 80, 80, 255);
+        else SDL_SetRenderDrawColor(renderer, 80, 220, 120, 255);
+        SDL_RenderDrawLine(renderer, x, bottom, x, bottom - h);
+    }
+
+    // 16.7 ms reference
+    int budget = bottom - static_cast<int>(16.7f / GRAPH_MAX_MS * GRAPH_HEIGHT);
+    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 90);
+    SDL_RenderDrawLine(renderer, X + 6, budget, X + WIDTH - 8, budget);
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <string>
+#include <vector>
+#include "Utils/Telemetry.hpp"
+#include "Utils/TextRasterizer.hpp"
+
+// Performance overlay drawn over any state (Settings > Performance HUD):
+// frame-time graph, p50/p99, live textures and memory. It only reads what
+// Telemetry has already cached, and re-rasterizes its text a few times a
+// second rather than every frame, so showing it barely moves the numbers.
+class PerfHud {
+public:
+    ~PerfHud();
+    void render(SDL_Renderer* renderer, TextRasterizer& text, const Telemetry& telemetry);
+    void release(); // Textures go before the renderer
+
+private:
+    static constexpr int X = 380;
+    static constexpr int Y = 4;
+    static constexpr int WIDTH = 256;
+    static constexpr int LINE_HEIGHT = 16;
+    static constexpr int GRAPH_HEIGHT = 40;
+    static constexpr float GRAPH_MAX_MS = 50.0f;
+    static constexpr Uint32 TEXT_REFRESH_MS = 500;
+
+    struct TextLine {
+        std::string text;
+        SDL_Texture* texture = nullptr;
+        int w = 0, h = 0;
+    };
+    std::vector<TextLine> lines;
+    Uint32 lastRefresh = 0;
+    unsigned long lastCreatedTextures = 0;
+
+    std::vector<std::string> describe(const Telemetry& telemetry);
+    void setLine(SDL_Renderer* renderer, TextRasterizer& rasterizer, size_t index, const std::string& text);
+    void renderGraph(SDL_Renderer* renderer, const Telemetry& telemetry, int top);
+};
@@ -6,8 +6,9 @@
 
 // Forward declaration
 class App;
+class SessionSnapshot;
 
-class State {
+class State : public std::enable_shared_from_this<State> {
 public:
     virtual ~State() = default;
 
@@ -16,4 +17,31 @@ public:
     virtual void handleEvent(App& app, const SDL_Event& event) = 0;
     virtual void update(App& app) = 0;
     virtual void render(App& app, SDL_Renderer* renderer) = 0;
+    virtual const char* name() const = 0;
+
+    // Pooled states (App::pooledState) outlive a visit: the first visit gets
+    // enter(), later ones resume(), and leaving calls suspend() instead of exit().
+    // The defaults keep a state that doesn't care behaving as if it were fresh.
+    virtual void suspend(App& app) { exit(app); }
+    virtual void resume(App& app) { enter(app); }
+    // Memory pressure: drop whatever resume() can rebuild. Only called while suspended.
+    virtual void trim(App& app) {}
+
+    // Memory accounting: estimated bytes held by the state's own data, checked
+    // by App about once a second. Over the budget (0: none), App calls
+    // shedMemory() until it is back under or the state has nothing left to drop.
+    virtual size_t memoryUsage() const { return 0; }
+    virtual size_t memoryBudget() const { return 0; }
+    virtual bool shedMemory(App& app) { return false; }
+
+    // Session snapshot: App calls saveSession() on the current state every few
+    // seconds; put() only the sections that changed. restoreSession() runs at
+    // launch, before the state is first activated; false falls back to the browser.
+    virtual void saveSession(App& app, SessionSnapshot& session) {}
+    virtual bool restoreSession(App& app, const SessionSnapshot& session) { return false; }
+
+protected:
+    // For async completions that may arrive after the state has been replaced
+    template <typename T>
+    std::weak_ptr<T> weakSelf() { return std::static_pointer_cast<T>(shared_from_this()); }
 };
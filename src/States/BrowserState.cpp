@@ -2,92 +2,412 @@
 #include "EditorState.hpp"
 #include "CanvasState.hpp"
 #include "SettingsState.hpp"
+#include "TasksState.hpp"
 #include <iostream>
+#include <algorithm>
 
 void BrowserState::enter(App& app) {
-    fileList = FileSystem::listFiles(app.isVaultUnlocked());
     selectedIndex = 0;
+    setupRibbon(app);
+    refreshList(app);
     std::cout << "Entered Browser State" << std::endl;
 }
 
+// Back from another state: selection, sort and any filter are kept
+void BrowserState::resume(App& app) {
+    setupRibbon(app);
+    refreshList(app);
+}
+
+void BrowserState::trim(App& app) {
+    if (!filtering) ribbon.reset();
+}
+
+void BrowserState::setupRibbon(App& app) {
+    const auto& settings = app.getSettings();
+    if (!ribbon) {
+        ribbon = std::make_shared<InputEngine>(app.getTextRasterizer());
+        ribbon->setCrankEnabled(false);
+    }
+    // Settings may have changed while we were covered
+    ribbon->setLerpStrength(settings.lerpStrength);
+    ribbon->setKeyboardLayout(settings.useAlphabeticalRibbon);
+}
+
+void BrowserState::refreshList(App& app) {
+    // Public notes come straight from the listing cache, no directory walk
+    ListingCache& cache = app.getListingCache();
+    vaultFiles.clear();
+    waitingForListing = !cache.isLoaded();
+    loading = waitingForListing;
+    if (waitingForListing) {
+        // Still loading at startup; update() comes back here once it's done
+        rebuildList();
+        return;
+    }
+    publicFiles = cache.entries();
+    listVersion = cache.version();
+    rebuildList();
+    if (!app.isVaultUnlocked()) return;
+
+    // Vault rows need the FileSystem lock, which a long save may be holding
+    loading = true;
+    auto self = weakSelf<BrowserState>();
+    app.getIOWorker().run<std::vector<FileEntry>>(
+        []() { return FileSystem::listVaultFiles(); },
+        [self](const std::vector<FileEntry>& vault) {
+            auto browser = self.lock();
+            if (!browser) return;
+            browser->vaultFiles = vault;
+            browser->loading = false;
+            browser->rebuildList();
+        });
+}
+
+// Sorting happens here, once per change, never per frame
+void BrowserState::rebuildList() {
+    std::string selectedName;
+    if (selectedIndex >= 0 && selectedIndex < rowCount()) {
+        selectedName = row(selectedIndex).name;
+    }
+
+    fileList.clear();
+    fileList.reserve(publicFiles.size() + vaultFiles.size());
+    fileList.insert(fileList.end(), publicFiles.begin(), publicFiles.end());
+    fileList.insert(fileList.end(), vaultFiles.begin(), vaultFiles.end());
+
+    auto byName = [](const FileEntry& a, const FileEntry& b) { return a.displayName < b.displayName; };
+    switch (sortMode) {
+        case SortMode::NAME:
+            std::sort(fileList.begin(), fileList.end(), byName);
+            break;
+        case SortMode::MODIFIED: // Newest first
+            std::sort(fileList.begin(), fileList.end(), [&](const FileEntry& a, const FileEntry& b) {
+                return a.modified != b.modified ? a.modified > b.modified : byName(a, b);
+            });
+            break;
+        case SortMode::SIZE: // Largest first
+            std::sort(fileList.begin(), fileList.end(), [&](const FileEntry& a, const FileEntry& b) {
+                return a.size != b.size ? a.size > b.size : byName(a, b);
+            });
+            break;
+    }
+
+    if (filtering) {
+        std::vector<std::string> names;
+        names.reserve(fileList.size());
+        for (const auto& file : fileList) names.push_back(file.displayName);
+        filter.setCandidates(names); // Re-runs the current query
+    }
+
+    // Keep the cursor on the same note across re-sorts and live updates
+    if (!selectedName.empty()) {
+        for (int i = 0; i < rowCount(); ++i) {
+            if (row(i).name == selectedName) {
+                selectedIndex = i;
+                break;
+            }
+        }
+    }
+    clampSelection();
+}
+
+void BrowserState::clampSelection() {
+    if (selectedIndex >= rowCount()) {
+        selectedIndex = rowCount() == 0 ? 0 : rowCount() - 1;
+    }
+    if (selectedIndex < 0) selectedIndex = 0;
+}
+
+int BrowserState::rowCount() const {
+    return filtering ? filter.results().size() : fileList.size();
+}
+
+const FileEntry& BrowserState::row(int index) const {
+    return filtering ? fileList[filter.results()[index].index] : fileList[index];
+}
+
+void BrowserState::startFilter() {
+    filtering = true;
+    filter.clear();
+    std::vector<std::string> names;
+    names.reserve(fileList.size());
+    for (const auto& file : fileList) names.push_back(file.displayName);
+    filter.setCandidates(names);
+    selectedIndex = 0;
+}
+
+void BrowserState::stopFilter() {
+    // Land on the note that was highlighted in the results
+    std::string selectedName = rowCount() > 0 ? row(selectedIndex).name : "";
+    filtering = false;
+    filter.clear();
+    for (int i = 0; i < rowCount(); ++i) {
+        if (row(i).name == selectedName) {
+            selectedIndex = i;
+            break;
+        }
+    }
+    clampSelection();
+}
+
+// Ribbon keys edit the query; everything else falls through to the browser
+bool BrowserState::handleFilterEvent(App& app, const SDL_Event& event) {
+    if (event.type != SDL_KEYDOWN) return false;
+    switch (event.key.keysym.sym) {
+        case SDLK_ESCAPE:
+            stopFilter();
+            return true;
+        case SDLK_b: // Backspace; leaves the filter once the query is empty
+            if (filter.query().empty()) {
+                stopFilter();
+            } else {
+                filter.pop();
+                selectedIndex = 0;
+            }
+            return true;
+    }
+
+    if (!ribbon->handleEvent(event)) return false;
+    std::string typed = ribbon->popInput();
+    if (!typed.empty()) {
+        for (char c : typed) filter.push(c); // Only re-scores the previous matches
+        selectedIndex = 0;
+    }
+    return true;
+}
+
+void BrowserState::moveSelection(int delta, bool wrap) {
+    int count = rowCount();
+    if (count == 0) return;
+    int next = selectedIndex + delta;
+    if (wrap) {
+        next = (next % count + count) % count;
+    } else {
+        next = std::max(0, std::min(count - 1, next));
+    }
+    selectedIndex = next;
+}
+
+int BrowserState::listBottom(App& app) const {
+    // The ribbon takes the bottom of the screen while filtering, the preview footer otherwise
+    return filtering ? 400 : app.getScreenHeight() - footerHeight;
+}
+
+int BrowserState::visibleRows(App& app) const {
+    return (listBottom(app) - listTop) / lineHeight;
+}
+
+std::string BrowserState::sortLabel() const {
+    switch (sortMode) {
+        case SortMode::MODIFIED: return "Sort: Date";
+        case SortMode::SIZE: return "Sort: Size";
+        default: return "Sort: Name";
+    }
+}
+
 void BrowserState::exit(App& app) {
     // Cleanup if needed
 }
 
 void BrowserState::handleEvent(App& app, const SDL_Event& event) {
+    if (filtering && handleFilterEvent(app, event)) return;
+
     if (event.type == SDL_KEYDOWN) {
         switch (event.key.keysym.sym) {
             case SDLK_UP:
-                selectedIndex--;
-                if (selectedIndex < 0) selectedIndex = fileList.size() - 1;
+                moveSelection(-1, true);
                 break;
             case SDLK_DOWN:
-                selectedIndex++;
-                if (selectedIndex >= fileList.size()) selectedIndex = 0;
+                moveSelection(1, true);
+                break;
+            case SDLK_LEFT: // Page up
+                moveSelection(-visibleRows(app), false);
+                break;
+            case SDLK_RIGHT: // Page down
+                moveSelection(visibleRows(app), false);
+                break;
+            case SDLK_q: // L1: Filter by name
+                startFilter();
+                break;
+            case SDLK_e: // R1: Cycle sort mode
+                sortMode = static_cast<SortMode>((static_cast<int>(sortMode) + 1) % 3);
+                rebuildList();
                 break;
             case SDLK_a: // Open
             case SDLK_RETURN: // START: Open File
-                if (!fileList.empty()) {
-                    app.changeState(std::make_shared<EditorState>(fileList[selectedIndex]));
+                if (!loading && rowCount() > 0) { // List may be stale while loading
+                    const FileEntry& file = row(selectedIndex);
+                    auto editor = app.pooledState<EditorState>();
+                    editor->open(file.name, file.isVault);
+                    app.pushState(editor);
                 }
                 break;
             case SDLK_x: // New File (Editor)
-                app.changeState(std::make_shared<EditorState>(""));
+                {
+                    auto editor = app.pooledState<EditorState>();
+                    editor->open("");
+                    app.pushState(editor);
+                }
                 break;
             case SDLK_c: // New Canvas
-                 app.changeState(std::make_shared<CanvasState>());
+                 app.pushState(app.pooledState<CanvasState>());
                  break;
+            case SDLK_t: // Open Tasks across all notes
+                app.pushState(app.pooledState<TasksState>());
+                break;
             case SDLK_y: // Privatize (Simulated 'Y' button)
-                if (!fileList.empty()) {
-                    std::string file = fileList[selectedIndex];
-                    if (file.find("[LOCKED]") == std::string::npos) {
-                        FileSystem::privatizeFile(file);
-                        // Refresh list
-                        fileList = FileSystem::listFiles(app.isVaultUnlocked());
+                if (!loading && rowCount() > 0) { // List may be stale while loading
+                    const FileEntry& file = row(selectedIndex);
+                    if (!file.isVault) {
+                        std::string name = file.name;
+                        TaskIndex& index = app.getTaskIndex();
+                        ListingCache& cache = app.getListingCache();
+                        loading = true;
+                        app.getDocumentCache().remove(DocumentCache::keyFor(name, false));
+                        auto self = weakSelf<BrowserState>();
+                        app.getIOWorker().submit([name, &index, &cache]() {
+                            if (FileSystem::privatizeFile(name)) {
+                                index.removeNote(name);
+                                index.save();
+                            }
+                            cache.poll();
+                        }, [self, &app]() {
+                            // The listing cache has seen the delete by now
+                            if (auto browser = self.lock()) browser->refreshList(app);
+                        });
                     }
                 }
                 break;
             case SDLK_BACKSPACE: // Select / Settings
-                app.changeState(std::make_shared<SettingsState>());
+                app.pushState(app.pooledState<SettingsState>());
                 break;
         }
     }
 }
 
 void BrowserState::update(App& app) {
-    // Animation logic if any
+    // Pick up notes created, saved or deleted since the last frame
+    ListingCache& cache = app.getListingCache();
+    if (waitingForListing) {
+        if (cache.isLoaded()) refreshList(app);
+    } else {
+        cache.pollAsync(app.getIOWorker());
+        uint64_t version = cache.version();
+        if (version != listVersion) {
+            publicFiles = cache.entries();
+            listVersion = version;
+            rebuildList();
+            // Notes edited outside the app get their previews redone off-thread
+            cache.refreshPreviewsAsync(app.getIOWorker());
+        }
+    }
+
+    if (filtering) ribbon->update();
+
+    // Scroll only when the selection would leave the viewport (one row of margin)
+    int rows = visibleRows(app);
+    int maxTop = std::max(0, rowCount() - rows);
+    int top = static_cast<int>(targetScrollY) / lineHeight;
+    if (selectedIndex < top + 1) top = selectedIndex - 1;
+    if (selectedIndex > top + rows - 2) top = selectedIndex - rows + 2;
+    top = std::max(0, std::min(maxTop, top));
+    targetScrollY = static_cast<float>(top * lineHeight);
+
+    scrollY += (targetScrollY - scrollY) * app.getSettings().lerpStrength;
+    // Long jumps (wrap, page) shouldn't take seconds to settle
+    float maxLag = rows * lineHeight;
+    if (scrollY < targetScrollY - maxLag) scrollY = targetScrollY - maxLag;
+    if (scrollY > targetScrollY + maxLag) scrollY = targetScrollY + maxLag;
 }
 
 void BrowserState::render(App& app, SDL_Renderer* renderer) {
     SDL_SetRenderDrawColor(renderer, 20, 20, 30, 255);
     SDL_RenderClear(renderer);
 
-    TTF_Font* font = app.getFont();
     
-    renderText(renderer, font, "FILE BROWSER", 20, 20, {255, 200, 100, 255});
-    
-    int startY = 80;
-    int lineHeight = 40;
+    renderText(app, renderer, "FILE BROWSER", 20, 20, {255, 200, 100, 255}, FontManager::HEADER);
+    if (filtering) {
+        std::string query = "Find: " + filter.query() + "_  (" + std::to_string(rowCount()) + ")";
+        renderText(app, renderer, query, 220, 20, {255, 255, 255, 255});
+        ribbon->render(renderer);
+    } else {
+        renderText(app, renderer, sortLabel(), 300, 20, {120, 120, 140, 255});
+    }
+
+    if (loading) {
+        // Public rows stay visible; this only covers startup, the vault fetch / privatize
+        std::string dots(1 + (SDL_GetTicks() / 300) % 3, '.');
+        renderText(app, renderer, "Loading" + dots, 500, 20, {150, 150, 150, 255});
+    }
+
+    if (rowCount() == 0) {
+        if (filtering) renderText(app, renderer, "No matches.", 40, 200, {100, 100, 100, 255});
+        else if (!loading) renderText(app, renderer, "No files found. Press START to create new.", 40, 200, {100, 100, 100, 255});
+        return;
+    }
+
+    // Rows partially scrolled out are clipped to the list area
+    int listHeight = listBottom(app) - listTop;
+    SDL_Rect clip = {0, listTop, app.getScreenWidth(), listHeight};
+    SDL_RenderSetClipRect(renderer, &clip);
 
-    for (size_t i = 0; i < fileList.size(); ++i) {
+    int first = std::max(0, static_cast<int>(scrollY) / lineHeight);
+    int last = std::min(rowCount() - 1, first + visibleRows(app) + 1);
+    for (int i = first; i <= last; ++i) {
         SDL_Color col = {150, 150, 150, 255};
         if (i == selectedIndex) col = {255, 255, 255, 255};
-        
-        renderText(renderer, font, fileList[i], 40, startY + (i * lineHeight), col);
+        int y = listTop + i * lineHeight - static_cast<int>(scrollY);
+        const FileEntry& file = row(i);
+        renderText(app, renderer, file.isVault ? "[LOCKED] " + file.displayName : file.displayName, 40, y, col);
+
+        // Task summary straight from the cached preview, no file reads
+        const NotePreview& preview = file.preview;
+        int tasks = preview.openTasks + preview.doneTasks;
+        if (preview.valid && tasks > 0) {
+            std::string summary = std::to_string(preview.doneTasks) + "/" + std::to_string(tasks);
+            SDL_Color tint = preview.openTasks > 0 ? SDL_Color{200, 170, 90, 255} : SDL_Color{100, 160, 100, 255};
+            renderText(app, renderer, summary, 540, y, tint);
+        }
+    }
+
+    SDL_RenderSetClipRect(renderer, NULL);
+
+    if (!filtering) renderPreview(app, renderer, row(selectedIndex));
+
+    // Scrollbar once the list outgrows the screen
+    int total = rowCount() * lineHeight;
+    if (total > listHeight) {
+        int thumbHeight = std::max(20, listHeight * listHeight / total);
+        int thumbY = listTop + static_cast<int>((listHeight - thumbHeight) * (scrollY / (total - listHeight)));
+        SDL_Rect thumb = {app.getScreenWidth() - 8, thumbY, 4, thumbHeight};
+        SDL_SetRenderDrawColor(renderer, 100, 100, 120, 255);
+        SDL_RenderFillRect(renderer, &thumb);
     }
+}
+
+void BrowserState::renderPreview(App& app, SDL_Renderer* renderer, const FileEntry& file) {
+    int y = listBottom(app);
+    SDL_Rect footer = {0, y, app.getScreenWidth(), footerHeight};
+    SDL_SetRenderDrawColor(renderer, 30, 30, 45, 255);
+    SDL_RenderFillRect(renderer, &footer);
 
-    if (fileList.empty()) {
-        renderText(renderer, font, "No files found. Press START to create new.", 40, 200, {100, 100, 100, 255});
+    const NotePreview& preview = file.preview;
+    if (!preview.valid) {
+        renderText(app, renderer, "...", 20, y + 8, {100, 100, 100, 255});
+        return;
     }
+
+    renderText(app, renderer, preview.text.substr(0, 40), 20, y + 8, {170, 170, 170, 255});
+
+    char date[16] = "";
+    std::time_t modified = file.modified;
+    std::strftime(date, sizeof(date), "%Y-%m-%d", std::localtime(&modified));
+    std::string meta = date;
+    if (preview.lines >= 0) meta = std::to_string(preview.lines) + "L  " + meta;
+    renderText(app, renderer, meta, 470, y + 8, {110, 110, 130, 255});
 }
 
-void BrowserState::renderText(SDL_Renderer* renderer, TTF_Font* font, const std::string& text, int x, int y, SDL_Color color) {
-    if (text.empty()) return;
-    SDL_Surface* surface = TTF_RenderText_Blended(font, text.c_str(), color);
-    if (!surface) return;
-    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-    SDL_Rect dst = {x, y, surface->w, surface->h};
-    SDL_RenderCopy(renderer, texture, NULL, &dst);
-    SDL_DestroyTexture(texture);
-    SDL_FreeSurface(surface);
+void BrowserState::renderText(App& app, SDL_Renderer* renderer, const std::string& text, int x, int y, SDL_Color color, Font font) {
+    app.getTextRasterizer().draw(renderer, font, text, color, x, y);
 }
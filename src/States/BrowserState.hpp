@@ -1,7 +1,9 @@
 #pragma once
 #include "../State.hpp"
 #include "../App.hpp"
+#include "../InputEngine.hpp"
 #include "../Utils/FileSystem.hpp"
+#include "../Utils/FuzzyFilter.hpp"
 #include <vector>
 #include <string>
 
@@ -12,10 +14,51 @@ public:
     void handleEvent(App& app, const SDL_Event& event) override;
     void update(App& app) override;
     void render(App& app, SDL_Renderer* renderer) override;
+    const char* name() const override { return "Browser"; }
+    void suspend(App& app) override {}
+    void resume(App& app) override;
+    void trim(App& app) override;
+
+    // Re-read the listing (vault toggled, privatize finished)
+    void refreshList(App& app);
 
 private:
-    std::vector<std::string> fileList;
+    enum class SortMode { NAME, MODIFIED, SIZE };
+
+    std::vector<FileEntry> publicFiles; // Snapshot of the listing cache
+    std::vector<FileEntry> vaultFiles;
+    std::vector<FileEntry> fileList;    // Merged and sorted, what is shown
+    uint64_t listVersion = 0;
+    SortMode sortMode = SortMode::NAME;
     int selectedIndex = 0;
+    bool loading = false;
+    bool waitingForListing = false; // Listing cache still loading at startup
+
+    // Virtualized list: only rows inside the viewport are rasterized
+    const int listTop = 80;
+    const int lineHeight = 40;
+    const int footerHeight = 40; // Preview of the selected note
+    float scrollY = 0.0f;       // Pixels, lerps towards targetScrollY
+    float targetScrollY = 0.0f;
+
+    // Type-to-filter: the ribbon types the query, rows become filter results
+    bool filtering = false;
+    FuzzyFilter filter;
+    std::shared_ptr<InputEngine> ribbon;
+
+    void rebuildList();
+    void clampSelection();
+    int rowCount() const;
+    const FileEntry& row(int index) const;
+    void setupRibbon(App& app);
+    void startFilter();
+    void stopFilter();
+    bool handleFilterEvent(App& app, const SDL_Event& event);
+    int listBottom(App& app) const;
+    void moveSelection(int delta, bool wrap);
+    int visibleRows(App& app) const;
+    std::string sortLabel() const;
+    void renderPreview(App& app, SDL_Renderer* renderer, const FileEntry& file);
     
-    void renderText(SDL_Renderer* renderer, TTF_Font* font, const std::string& text, int x, int y, SDL_Color color);
+    void renderText(App& app, SDL_Renderer* renderer, const std::string& text, int x, int y, SDL_Color color, Font font = FontManager::BODY);
 };
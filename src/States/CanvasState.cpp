@@ -1,9 +1,71 @@
 #include "CanvasState.hpp"
 #include "../App.hpp"
 #include "BrowserState.hpp"
+#include "../Utils/SessionSnapshot.hpp"
 #include <cmath>
+#include <algorithm>
 #include <iostream>
 
+namespace {
+
+// What the session keeps of the canvas, copied for the worker to encode
+struct SessionCanvas {
+    CanvasSnapshot canvas;
+    int selectedShapeIndex;
+    HistoryManager<CanvasSnapshot> history;
+};
+
+void writeCanvas(SnapshotWriter& out, const CanvasSnapshot& canvas) {
+    out.i32(canvas.nextId);
+    out.u32(static_cast<uint32_t>(canvas.shapes.size()));
+    for (const auto& shape : canvas.shapes) {
+        out.u8(static_cast<uint8_t>(shape.type));
+        out.f32(shape.x);
+        out.f32(shape.y);
+        out.f32(shape.w);
+        out.f32(shape.h);
+        out.u8(shape.color.r);
+        out.u8(shape.color.g);
+        out.u8(shape.color.b);
+        out.u8(shape.color.a);
+        out.str(shape.text);
+        out.i32(shape.id);
+    }
+    out.u32(static_cast<uint32_t>(canvas.arrows.size()));
+    for (const auto& arrow : canvas.arrows) {
+        out.i32(arrow.startShapeId);
+        out.i32(arrow.endShapeId);
+    }
+}
+
+CanvasSnapshot readCanvas(SnapshotReader& in) {
+    CanvasSnapshot canvas;
+    canvas.nextId = in.i32();
+    canvas.shapes.resize(in.count(29));
+    for (auto& shape : canvas.shapes) {
+        uint8_t type = in.u8();
+        shape.type = type <= static_cast<uint8_t>(ShapeType::TEXT_NODE) ? static_cast<ShapeType>(type) : ShapeType::SQUARE;
+        shape.x = in.f32();
+        shape.y = in.f32();
+        shape.w = in.f32();
+        shape.h = in.f32();
+        shape.color.r = in.u8();
+        shape.color.g = in.u8();
+        shape.color.b = in.u8();
+        shape.color.a = in.u8();
+        shape.text = in.str();
+        shape.id = in.i32();
+    }
+    canvas.arrows.resize(in.count(8));
+    for (auto& arrow : canvas.arrows) {
+        arrow.startShapeId = in.i32();
+        arrow.endShapeId = in.i32();
+    }
+    return canvas;
+}
+
+} // namespace
+
 void CanvasState::enter(App& app) {
     // Start with one shape if empty
     if (shapes.empty()) {
@@ -16,11 +78,60 @@ void CanvasState::enter(App& app) {
 void CanvasState::exit(App& app) {
 }
 
+// Drawings outlive the visit (the state is pooled), so they stay in the session whatever is on top
+void CanvasState::saveSession(App& app, SessionSnapshot& session) {
+    if (sessionRevision == savedSessionRevision) return;
+    // Copied here, encoded on the worker
+    auto copy = std::make_shared<const SessionCanvas>(SessionCanvas{createSnapshot(), selectedShapeIndex, history});
+    session.putDeferred(SessionSection::CANVAS, [copy]() {
+        SnapshotWriter out;
+        writeCanvas(out, copy->canvas);
+        out.i32(copy->selectedShapeIndex);
+        out.u32(static_cast<uint32_t>(copy->history.undoStates().size()));
+        for (const auto& state : copy->history.undoStates()) writeCanvas(out, state);
+        out.u32(static_cast<uint32_t>(copy->history.redoStates().size()));
+        for (const auto& state : copy->history.redoStates()) writeCanvas(out, state);
+        return out.data;
+    });
+    savedSessionRevision = sessionRevision;
+}
+
+bool CanvasState::restoreSession(App& app, const SessionSnapshot& session) {
+    const std::string* data = session.get(SessionSection::CANVAS);
+    if (!data) return true; // Never drawn on: a fresh canvas is the right thing to show
+    SnapshotReader in(*data);
+    CanvasSnapshot current = readCanvas(in);
+    int selected = in.i32();
+    std::deque<CanvasSnapshot> undo(in.count(12));
+    for (auto& state : undo) state = readCanvas(in);
+    std::vector<CanvasSnapshot> redo(in.count(12));
+    for (auto& state : redo) state = readCanvas(in);
+    if (!in.ok()) return true;
+
+    loadSnapshot(current);
+    selectedShapeIndex = (selected >= 0 && selected < static_cast<int>(shapes.size())) ? selected : (shapes.empty() ? -1 : 0);
+    history.restore(std::move(undo), std::move(redo));
+    savedSessionRevision = sessionRevision; // Identical to what's on the card
+    return true;
+}
+
+size_t CanvasState::memoryUsage() const {
+    // Undo steps are full copies of roughly the same size
+    return sizeof(*this) + CanvasSnapshot::footprint(shapes, arrows) * (1 + history.depth());
+}
+
+bool CanvasState::shedMemory(App& app) {
+    size_t dropped = history.dropOldest(std::max<size_t>(1, history.undoStates().size() / 2));
+    if (dropped > 0) std::cout << "Canvas: dropped the " << dropped << " oldest undo steps to free memory" << std::endl;
+    return dropped > 0;
+}
+
 CanvasSnapshot CanvasState::createSnapshot() const {
     return {shapes, arrows, nextId};
 }
 
 void CanvasState::loadSnapshot(const CanvasSnapshot& snapshot) {
+    sessionRevision++;
     shapes = snapshot.shapes;
     arrows = snapshot.arrows;
     nextId = snapshot.nextId;
@@ -32,6 +143,7 @@ void CanvasState::loadSnapshot(const CanvasSnapshot& snapshot) {
 
 void CanvasState::saveHistory() {
     history.push(createSnapshot());
+    sessionRevision++;
 }
 
 void CanvasState::addShape(ShapeType type, float x, float y) {
@@ -54,7 +166,7 @@ void CanvasState::handleEvent(App& app, const SDL_Event& event) {
         bool changed = false;
         switch (event.key.keysym.sym) {
             case SDLK_ESCAPE:
-                app.changeState(std::make_shared<BrowserState>());
+                app.popState();
                 break;
             
             // Undo/Redo
@@ -116,7 +228,7 @@ void CanvasState::handleEvent(App& app, const SDL_Event& event) {
     }
 
     // Movement & Scaling
-    const Uint8* state = SDL_GetKeyboardState(NULL);
+    const Uint8* state = app.getKeyboardState();
     if (selectedShapeIndex >= 0 && selectedShapeIndex < shapes.size()) {
         Shape& s = shapes[selectedShapeIndex];
         float speed = 2.0f;
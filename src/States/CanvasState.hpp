@@ -51,6 +51,13 @@ struct CanvasSnapshot {
     bool operator==(const CanvasSnapshot& other) const {
         return shapes == other.shapes && arrows == other.arrows && nextId == other.nextId;
     }
+
+    // Estimated heap bytes of a drawing, from capacities
+    static size_t footprint(const std::vector<Shape>& shapes, const std::vector<Arrow>& arrows) {
+        size_t bytes = shapes.capacity() * sizeof(Shape) + arrows.capacity() * sizeof(Arrow);
+        for (const Shape& shape : shapes) bytes += shape.text.capacity();
+        return bytes;
+    }
 };
 
 #include "../Utils/HistoryManager.hpp"
@@ -62,8 +69,16 @@ public:
     void handleEvent(App& app, const SDL_Event& event) override;
     void update(App& app) override;
     void render(App& app, SDL_Renderer* renderer) override;
+    const char* name() const override { return "Canvas"; }
+    void saveSession(App& app, SessionSnapshot& session) override;
+    bool restoreSession(App& app, const SessionSnapshot& session) override;
+    size_t memoryUsage() const override;
+    size_t memoryBudget() const override { return MEMORY_BUDGET; }
+    bool shedMemory(App& app) override;
 
 private:
+    static constexpr size_t MEMORY_BUDGET = 4 * 1024 * 1024;
+
     std::vector<Shape> shapes;
     std::vector<Arrow> arrows;
     int selectedShapeIndex = -1;
@@ -74,6 +89,8 @@ private:
     void saveHistory();
     void loadSnapshot(const CanvasSnapshot& snapshot);
     CanvasSnapshot createSnapshot() const;
+    int sessionRevision = 0;
+    int savedSessionRevision = 0; // Nothing worth keeping until the first edit
 
     // Clipboard
     Shape clipboardShape;
@@ -1,10 +1,9 @@
 #include "DecoyState.hpp"
 #include "../App.hpp"
+#include "../Utils/Telemetry.hpp"
 #include <cstdlib>
 
-DecoyState::DecoyState(int mode) : mode(mode) {}
-
-void DecoyState::enter(App& app) {
+DecoyState::DecoyState(int mode) : mode(mode) {
     if (mode == 0) { // Fake Update
         logLines = {
             "[SYSTEM] Kernel Panic: VFS unable to mount root fs on unknown-block(0,0)",
@@ -40,8 +39,61 @@ void DecoyState::enter(App& app) {
     // Mode 2 is Black Screen (Empty logs)
 }
 
+DecoyState::~DecoyState() {
+    releaseTextures();
+}
+
+void DecoyState::enter(App& app) {
+    scrollOffset = 0.0f;
+    if (!prerendered) prerender(app.getRenderer(), app.getTextRasterizer()); // Startup didn't get to it
+}
+
 void DecoyState::exit(App& app) {}
 
+void DecoyState::prerender(SDL_Renderer* renderer, TextRasterizer& rasterizer) {
+    releaseTextures();
+
+    // Warning Header
+    if (mode == 0) {
+        SDL_Color red = {255, 50, 50, 255};
+        headerTextures.push_back(makeText(renderer, rasterizer, FontManager::HEADER, "CRITICAL UPDATE: SAVING SYSTEM STATE", red, 40, 40));
+        headerTextures.push_back(makeText(renderer, rasterizer, FontManager::HEADER, "DO NOT POWER OFF", red, 40, 80));
+    } else if (mode == 1) {
+        SDL_Color red = {255, 0, 0, 255};
+        headerTextures.push_back(makeText(renderer, rasterizer, FontManager::HEADER, "FATAL ERROR", red, 40, 40));
+    }
+
+    SDL_Color green = {50, 255, 50, 255};
+    if (mode == 1) green = {200, 200, 200, 255};
+    for (const auto& line : logLines) {
+        lineTextures.push_back(makeText(renderer, rasterizer, FontManager::SMALL, line, green, 40, 0));
+    }
+    prerendered = true;
+}
+
+DecoyState::PrerenderedText DecoyState::makeText(SDL_Renderer* renderer, TextRasterizer& rasterizer, Font font, const std::string& text, SDL_Color color, int x, int y) {
+    PrerenderedText result;
+    result.x = x;
+    result.y = y;
+    SDL_Surface* surf = rasterizer.render(font, text, color);
+    if (surf) {
+        result.texture = SDL_CreateTextureFromSurface(renderer, surf);
+        if (result.texture) Telemetry::textureCreated();
+        result.w = surf->w;
+        result.h = surf->h;
+        SDL_FreeSurface(surf);
+    }
+    return result;
+}
+
+void DecoyState::releaseTextures() {
+    for (auto& text : headerTextures) if (text.texture) { SDL_DestroyTexture(text.texture); Telemetry::textureDestroyed(); }
+    for (auto& text : lineTextures) if (text.texture) { SDL_DestroyTexture(text.texture); Telemetry::textureDestroyed(); }
+    headerTextures.clear();
+    lineTextures.clear();
+    prerendered = false;
+}
+
 void DecoyState::handleEvent(App& app, const SDL_Event& event) {
     // Consume all input. No escape.
 }
@@ -60,60 +112,25 @@ void DecoyState::render(App& app, SDL_Renderer* renderer) {
     SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
     SDL_RenderClear(renderer);
 
-    TTF_Font* font = app.getFont();
-    
     // Warning Header
-    if (mode == 0) {
-        SDL_Color red = {255, 50, 50, 255};
-        SDL_Surface* surf = TTF_RenderText_Blended(font, "CRITICAL UPDATE: SAVING SYSTEM STATE", red);
-        if (surf) {
-            SDL_Texture* tex = SDL_CreateTextureFromSurface(renderer, surf);
-            SDL_Rect dst = {40, 40, surf->w, surf->h};
-            SDL_RenderCopy(renderer, tex, NULL, &dst);
-            SDL_FreeSurface(surf);
-            SDL_DestroyTexture(tex);
-        }
-
-        surf = TTF_RenderText_Blended(font, "DO NOT POWER OFF", red);
-        if (surf) {
-            SDL_Texture* tex = SDL_CreateTextureFromSurface(renderer, surf);
-            SDL_Rect dst = {40, 80, surf->w, surf->h};
-            SDL_RenderCopy(renderer, tex, NULL, &dst);
-            SDL_FreeSurface(surf);
-            SDL_DestroyTexture(tex);
-        }
-    } else if (mode == 1) {
-        SDL_Color red = {255, 0, 0, 255};
-        SDL_Surface* surf = TTF_RenderText_Blended(font, "FATAL ERROR", red);
-        if (surf) {
-            SDL_Texture* tex = SDL_CreateTextureFromSurface(renderer, surf);
-            SDL_Rect dst = {40, 40, surf->w, surf->h};
-            SDL_RenderCopy(renderer, tex, NULL, &dst);
-            SDL_FreeSurface(surf);
-            SDL_DestroyTexture(tex);
-        }
+    for (const auto& text : headerTextures) {
+        if (!text.texture) continue;
+        SDL_Rect dst = {text.x, text.y, text.w, text.h};
+        SDL_RenderCopy(renderer, text.texture, NULL, &dst);
     }
 
     // Scrolling Log
     int startY = 150;
     int lineHeight = 25;
-    SDL_Color green = {50, 255, 50, 255};
-    if (mode == 1) green = {200, 200, 200, 255};
 
-    for (size_t i = 0; i < logLines.size(); ++i) {
+    for (size_t i = 0; i < lineTextures.size(); ++i) {
         float y = startY + (i * lineHeight) - scrollOffset;
         
         // Loop log logic simplified: just let it scroll
         
-        if (y > 100 && y < 480) {
-            SDL_Surface* surf = TTF_RenderText_Blended(font, logLines[i].c_str(), green);
-            if (surf) {
-                SDL_Texture* tex = SDL_CreateTextureFromSurface(renderer, surf);
-                SDL_Rect dst = {40, (int)y, surf->w, surf->h};
-                SDL_RenderCopy(renderer, tex, NULL, &dst);
-                SDL_FreeSurface(surf);
-                SDL_DestroyTexture(tex);
-            }
+        if (y > 100 && y < 480 && lineTextures[i].texture) {
+            SDL_Rect dst = {lineTextures[i].x, (int)y, lineTextures[i].w, lineTextures[i].h};
+            SDL_RenderCopy(renderer, lineTextures[i].texture, NULL, &dst);
         }
     }
 }
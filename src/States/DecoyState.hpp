@@ -1,17 +1,37 @@
 #pragma once
 #include "../State.hpp"
+#include "../Utils/TextRasterizer.hpp"
+#include <vector>
+#include <string>
 
 class DecoyState : public State {
 public:
     DecoyState(int mode = 0);
+    ~DecoyState();
     void enter(App& app) override;
     void exit(App& app) override;
     void handleEvent(App& app, const SDL_Event& event) override;
     void update(App& app) override;
     void render(App& app, SDL_Renderer* renderer) override;
+    const char* name() const override { return "Decoy"; }
+
+    // Rasterize every line up front (App does this at startup), so the first
+    // decoy frame is texture copies only.
+    void prerender(SDL_Renderer* renderer, TextRasterizer& rasterizer);
 
 private:
+    struct PrerenderedText {
+        SDL_Texture* texture = nullptr;
+        int x = 0, y = 0, w = 0, h = 0;
+    };
+
     int mode;
     float scrollOffset = 0.0f;
     std::vector<std::string> logLines;
+    std::vector<PrerenderedText> headerTextures;
+    std::vector<PrerenderedText> lineTextures;
+    bool prerendered = false;
+
+    PrerenderedText makeText(SDL_Renderer* renderer, TextRasterizer& rasterizer, Font font, const std::string& text, SDL_Color color, int x, int y);
+    void releaseTextures();
 };
@@ -2,35 +2,41 @@
 #include "../State.hpp"
 #include "../InputEngine.hpp"
 #include "../Utils/HistoryManager.hpp"
+#include "../Utils/NoteFormat.hpp"
+#include "../Utils/DocumentCache.hpp"
+#include <ctime>
 #include <vector>
 #include <string>
 
-struct Line {
-    std::string content;
-    char bulletType = '*'; // •, O, —, !, ?
-    bool completed = false;
-    float popScale = 1.0f; // For "Pop" animation
-    float opacity = 1.0f;
-
-    bool operator==(const Line& other) const {
-        return content == other.content && 
-               bulletType == other.bulletType && 
-               completed == other.completed;
-    }
-};
-
 class EditorState : public State {
 public:
-    EditorState(const std::string& filename = "");
+    // startLine < 0 keeps the cursor where the note was last left
+    EditorState(const std::string& filename = "", bool isVault = false, int startLine = -1);
     void enter(App& app) override;
     void exit(App& app) override;
     void handleEvent(App& app, const SDL_Event& event) override;
     void update(App& app) override;
     void render(App& app, SDL_Renderer* renderer) override;
+    const char* name() const override { return "Editor"; }
+    void resume(App& app) override;
+    void trim(App& app) override;
+    void saveSession(App& app, SessionSnapshot& session) override;
+    bool restoreSession(App& app, const SessionSnapshot& session) override;
+    size_t memoryUsage() const override;
+    size_t memoryBudget() const override { return MEMORY_BUDGET; }
+    bool shedMemory(App& app) override;
+
+    // Point the (pooled) editor at another note before showing it
+    void open(const std::string& filename, bool isVault = false, int startLine = -1);
 
 private:
+    static constexpr size_t MEMORY_BUDGET = 8 * 1024 * 1024; // Document plus undo copies
+
     std::shared_ptr<InputEngine> inputEngine;
     std::string currentFilename;
+    bool isVault = false;
+    std::string savedContent; // Serialized content as last loaded/saved
+    std::time_t cachedModified = 0; // File mtime matching savedContent, 0 if unknown
     
     // Layouts
     enum class Layout {
@@ -43,11 +49,41 @@ private:
     // Content
     std::vector<Line> lines;
     int currentLineIndex = 0;
+    int startLine = -1;
+    int scrollLine = 0; // First visible line
+    const int visibleLines = 11; // Rows from y=60 down to the ribbon
 
     // History
     HistoryManager<std::vector<Line>> history;
     void saveHistory();
 
+    // Persistence
+    bool loading = false;
+    bool readFailed = false; // The read came back empty-handed: never save over the file
+    int loadGeneration = 0; // Drops reads that finish after open() moved on
+    void loadNote(App& app);
+    void saveNote(App& app);
+    std::string newNoteName() const; // Preferred name; the IOWorker suffixes it if taken
+
+    void setupInput(App& app);
+    bool dictionaryApplied = false;
+    void applyDictionary(App& app);
+    void openDocument(App& app);
+    void closeDocument();
+
+    // Session snapshot: the document is re-encoded only when this moves on
+    int sessionRevision = 0;
+    int savedSessionRevision = -1;
+    int savedHistoryRevision = -1;
+    bool restoredFromSession = false; // openDocument() keeps what restoreSession() set up
+    void restoreHistory(const SessionSnapshot& session);
+
+    // Document cache: reopening a recent note skips the read and keeps undo
+    bool restoreDocument(App& app);
+    void checkModified(App& app);
+    void stashDocument(App& app);
+    std::shared_ptr<CachedDocument> makeCachedDocument() const;
+
     // Satisfaction System
     std::vector<char> bullets = {'*', 'O', '-', '!', '?'}; 
     float currentProgress = 0.0f; // For smooth Lerp animation of progress bar
@@ -56,5 +92,5 @@ private:
     void renderLayout(App& app, SDL_Renderer* renderer);
     void renderLines(App& app, SDL_Renderer* renderer, int startX, int startY, int width);
     void renderProgressBar(App& app, SDL_Renderer* renderer);
-    void renderText(SDL_Renderer* renderer, TTF_Font* font, const std::string& text, int x, int y, SDL_Color color, float scale = 1.0f);
+    void renderText(App& app, SDL_Renderer* renderer, const std::string& text, int x, int y, SDL_Color color, float scale = 1.0f);
 };
@@ -0,0 +1,89 @@
+#include "PassphraseState.hpp"
+#include "../App.hpp"
+#include <algorithm>
+#include <iostream>
+
+void PassphraseState::enter(App& app) {
+    const auto& settings = app.getSettings();
+    ribbon = std::make_shared<InputEngine>(app.getTextRasterizer());
+    ribbon->setCrankEnabled(false); // Predictions would leak the passphrase onto the screen
+    ribbon->setLerpStrength(settings.lerpStrength);
+    ribbon->setKeyboardLayout(settings.useAlphabeticalRibbon);
+    wipe();
+    checking = false;
+    rejected = false;
+}
+
+void PassphraseState::exit(App& app) {
+    wipe();
+    ribbon.reset();
+}
+
+void PassphraseState::wipe() {
+    std::fill(passphrase.begin(), passphrase.end(), '\0');
+    passphrase.clear();
+}
+
+void PassphraseState::submit(App& app) {
+    if (passphrase.empty() || checking) return;
+    checking = true;
+    rejected = false;
+    auto self = weakSelf<PassphraseState>();
+    app.unlockVault(passphrase, [self, &app](bool unlocked) {
+        auto state = self.lock();
+        if (!state) return;
+        state->checking = false;
+        state->wipe();
+        if (unlocked) app.popState();
+        else state->rejected = true;
+    });
+}
+
+void PassphraseState::handleEvent(App& app, const SDL_Event& event) {
+    if (event.type != SDL_KEYDOWN || checking) return;
+    switch (event.key.keysym.sym) {
+        case SDLK_ESCAPE: // Back: stays locked
+            app.popState();
+            return;
+        case SDLK_a: // Unlock
+            submit(app);
+            return;
+        case SDLK_b: // Backspace
+            if (!passphrase.empty()) passphrase.pop_back();
+            rejected = false;
+            return;
+    }
+    if (!ribbon->handleEvent(event)) return;
+    std::string typed = ribbon->popInput();
+    if (!typed.empty()) {
+        passphrase += typed;
+        rejected = false;
+    }
+}
+
+void PassphraseState::update(App& app) {
+    ribbon->update();
+}
+
+void PassphraseState::render(App& app, SDL_Renderer* renderer) {
+    SDL_SetRenderDrawColor(renderer, 20, 20, 30, 255);
+    SDL_RenderClear(renderer);
+
+    renderText(app, renderer, "VAULT PASSPHRASE", 20, 20, {255, 200, 100, 255}, FontManager::HEADER);
+    renderText(app, renderer, std::string(passphrase.size(), '*') + "_", 40, 160, {255, 255, 255, 255});
+
+    if (checking) {
+        renderText(app, renderer, "Checking...", 40, 220, {150, 150, 150, 255});
+    } else if (rejected) {
+        renderText(app, renderer, "Wrong passphrase.", 40, 220, {220, 100, 100, 255});
+    } else {
+        renderText(app, renderer, "A new vault takes the first passphrase given.", 40, 220, {100, 100, 100, 255}, FontManager::SMALL);
+    }
+    renderText(app, renderer, "START: type   B: delete   A: unlock   ESCAPE: cancel", 40, 340, {110, 110, 130, 255}, FontManager::SMALL);
+
+    ribbon->render(renderer);
+}
+
+void PassphraseState::renderText(App& app, SDL_Renderer* renderer, const std::string& text, int x, int y, SDL_Color color, Font font) {
+    app.getTextRasterizer().draw(renderer, font, text, color, x, y);
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include "../State.hpp"
+#include "../InputEngine.hpp"
+#include <memory>
+#include <string>
+
+// Asked for after the unlock gesture: the vault key is derived from what is
+// typed here on the ribbon, so the gesture alone opens nothing. Shown masked;
+// the text is wiped when the state is left.
+class PassphraseState : public State {
+public:
+    void enter(App& app) override;
+    void exit(App& app) override;
+    void handleEvent(App& app, const SDL_Event& event) override;
+    void update(App& app) override;
+    void render(App& app, SDL_Renderer* renderer) override;
+    const char* name() const override { return "Passphrase"; }
+
+private:
+    std::shared_ptr<InputEngine> ribbon;
+    std::string passphrase;
+    bool checking = false; // Key derivation runs on the IOWorker
+    bool rejected = false;
+
+    void wipe();
+    void submit(App& app);
+    void renderText(App& app, SDL_Renderer* renderer, const std::string& text, int x, int y, SDL_Color color, Font font = FontManager::BODY);
+};
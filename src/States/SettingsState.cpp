@@ -1,10 +1,12 @@
 #include "SettingsState.hpp"
 #include "../App.hpp"
 #include "BrowserState.hpp"
+#include "../Utils/FileSystem.hpp"
+#include "../Utils/Telemetry.hpp"
 #include <fstream>
 #include <sstream>
 #include <iomanip>
-#include <unistd.h> // for sysconf
+#include <algorithm>
 
 void SettingsState::enter(App& app) {
     buildMenu(app);
@@ -21,6 +23,7 @@ void SettingsState::enter(App& app) {
 
 void SettingsState::exit(App& app) {
     app.getSettings().save();
+    FileSystem::setCompression(app.getSettings().compressNotes);
 }
 
 void SettingsState::buildMenu(App& app) {
@@ -30,25 +33,28 @@ void SettingsState::buildMenu(App& app) {
     // [INPUT]
     items.push_back({"[ INPUT ]", ItemType::HEADER});
     items.push_back({"Keyboard Layout", ItemType::TOGGLE, &s.useAlphabeticalRibbon});
+    items.push_back({"Late Input", ItemType::TOGGLE, &s.lateInput});
     
     // [VISUALS]
     items.push_back({"[ VISUALS ]", ItemType::HEADER});
     items.push_back({"Lerp Strength", ItemType::SLIDER, nullptr, &s.lerpStrength, nullptr, 0.1f, 0.5f});
     items.push_back({"Stealth Mode", ItemType::TOGGLE, &s.stealthMode});
+    items.push_back({"Performance HUD", ItemType::TOGGLE, &s.showPerfHud});
 
     // [BUJO]
     items.push_back({"[ BUJO ]", ItemType::HEADER});
     items.push_back({"Default Template", ItemType::SELECTOR, nullptr, nullptr, &s.defaultTemplateIndex, 0.0f, 0.0f, 0, 2});
+    items.push_back({"Compress Notes", ItemType::TOGGLE, &s.compressNotes});
 
     // [SECURITY]
     items.push_back({"[ SECURITY ]", ItemType::HEADER});
-    items.push_back({"Decoy Screen", ItemType::SELECTOR, nullptr, nullptr, &s.decoyScreenIndex, 0.0f, 0.0f, 0, 2});
+    items.push_back({"Decoy Screen", ItemType::SELECTOR, nullptr, nullptr, &s.decoyScreenIndex, 0.0f, 0.0f, 0, AppSettings::DECOY_SCREEN_COUNT - 1});
 }
 
 void SettingsState::handleEvent(App& app, const SDL_Event& event) {
     if (event.type == SDL_KEYDOWN) {
         if (event.key.keysym.sym == SDLK_ESCAPE || event.key.keysym.sym == SDLK_b) {
-            app.changeState(std::make_shared<BrowserState>());
+            app.popState();
             return;
         }
 
@@ -98,6 +104,11 @@ void SettingsState::update(App& app) {
     targetSelectorY = 80 + selectedIndex * 40;
     float lerp = app.getSettings().lerpStrength;
     selectorY += (targetSelectorY - selectorY) * lerp;
+
+    // More items than fit above the footer: keep the selection on screen
+    int maxScroll = std::max(0, static_cast<int>(items.size()) - visibleItems) * 40;
+    float targetScroll = static_cast<float>(std::min(maxScroll, std::max(0, (selectedIndex - visibleItems + 1) * 40)));
+    scrollY += (targetScroll - scrollY) * lerp;
 }
 
 void SettingsState::render(App& app, SDL_Renderer* renderer) {
@@ -107,15 +118,19 @@ void SettingsState::render(App& app, SDL_Renderer* renderer) {
     SDL_RenderClear(renderer);
 
     // Header
-    renderText(renderer, app.getFont(), "SETTINGS", 320, 30, {255, 255, 255, 255});
+    renderText(app, renderer, "SETTINGS", 320, 30, {255, 255, 255, 255}, FontManager::HEADER);
+
+    SDL_Rect listClip = {0, 60, 640, 380};
+    SDL_RenderSetClipRect(renderer, &listClip);
 
     // Selector Bar
-    SDL_Rect selRect = {40, static_cast<int>(selectorY), 560, 36};
+    int scroll = static_cast<int>(scrollY);
+    SDL_Rect selRect = {40, static_cast<int>(selectorY) - scroll, 560, 36};
     SDL_SetRenderDrawColor(renderer, 100, 100, 150, 100);
     SDL_RenderFillRect(renderer, &selRect);
 
     // Items
-    int startY = 80;
+    int startY = 80 - scroll;
     for (size_t i = 0; i < items.size(); ++i) {
         int y = startY + i * 40;
         SDL_Color col = {200, 200, 200, 255};
@@ -123,9 +138,9 @@ void SettingsState::render(App& app, SDL_Renderer* renderer) {
         
         if (items[i].type == ItemType::HEADER) {
             col = {255, 200, 100, 255};
-            renderText(renderer, app.getFont(), items[i].label, 320, y + 18, col);
+            renderText(app, renderer, items[i].label, 320, y + 18, col);
         } else {
-            renderText(renderer, app.getFont(), items[i].label, 100, y + 18, col);
+            renderText(app, renderer, items[i].label, 100, y + 18, col);
             
             // Value
             std::string valStr;
@@ -152,54 +167,37 @@ void SettingsState::render(App& app, SDL_Renderer* renderer) {
                     else valStr = "Charting";
                 }
             }
-             renderText(renderer, app.getFont(), valStr, 500, y + 18, col);
+             renderText(app, renderer, valStr, 500, y + 18, col);
         }
     }
 
+    SDL_RenderSetClipRect(renderer, NULL);
+
     // Footer System Monitor
     int footerY = 440;
     SDL_SetRenderDrawColor(renderer, 20, 20, 20, 255);
     SDL_Rect footer = {0, footerY, 640, 40};
     SDL_RenderFillRect(renderer, &footer);
     
-    std::string stats = "MEM: " + getRAMUsage() + " | BAT: " + getBatteryLevel();
-    renderText(renderer, app.getFont(), stats, 320, footerY + 20, {150, 150, 150, 255});
+    // Sampled in the background; nothing here touches procfs/sysfs
+    SystemSample sample = app.getTelemetry().latest();
+    std::string stats = "MEM: " + getRAMUsage(sample) + " | BAT: " + getBatteryLevel(sample);
+    renderText(app, renderer, stats, 320, footerY + 20, {150, 150, 150, 255});
 }
 
-std::string SettingsState::getRAMUsage() {
-    // Simple mock or /proc/meminfo read
-    long pages = sysconf(_SC_AVPHYS_PAGES);
-    long page_size = sysconf(_SC_PAGESIZE);
-    long total_pages = sysconf(_SC_PHYS_PAGES);
-    
-    long free_mem = pages * page_size;
-    long total_mem = total_pages * page_size;
-    long used_mem = total_mem - free_mem;
-    
+std::string SettingsState::getRAMUsage(const SystemSample& sample) {
+    if (sample.memTotalKB < 0 || sample.memAvailableKB < 0) return "--";
+    long used = sample.memTotalKB - sample.memAvailableKB;
+
     // Convert to MB
-    return std::to_string(used_mem / 1024 / 1024) + "MB / " + std::to_string(total_mem / 1024 / 1024) + "MB";
+    return std::to_string(used / 1024) + "MB / " + std::to_string(sample.memTotalKB / 1024) + "MB";
 }
 
-std::string SettingsState::getBatteryLevel() {
-    // Try to read standard battery path
-    std::ifstream bat("/sys/class/power_supply/battery/capacity");
-    if (bat.is_open()) {
-        std::string cap;
-        bat >> cap;
-        return cap + "%";
-    }
+std::string SettingsState::getBatteryLevel(const SystemSample& sample) {
+    if (sample.batteryPercent >= 0) return std::to_string(sample.batteryPercent) + "%";
     return "100%"; // Mock
 }
 
-void SettingsState::renderText(SDL_Renderer* renderer, TTF_Font* font, const std::string& text, int x, int y, SDL_Color color) {
-    if (text.empty()) return;
-    SDL_Surface* surface = TTF_RenderText_Blended(font, text.c_str(), color);
-    if (!surface) return;
-    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-    int w = surface->w;
-    int h = surface->h;
-    SDL_Rect dst = {x - w/2, y - h/2, w, h}; // Center aligned
-    SDL_RenderCopy(renderer, texture, NULL, &dst);
-    SDL_DestroyTexture(texture);
-    SDL_FreeSurface(surface);
+void SettingsState::renderText(App& app, SDL_Renderer* renderer, const std::string& text, int x, int y, SDL_Color color, Font font) {
+    app.getTextRasterizer().draw(renderer, font, text, color, x, y, 1.0f, true); // Center aligned
 }
@@ -1,5 +1,7 @@
 #pragma once
 #include "../State.hpp"
+#include "../Utils/FontManager.hpp"
+#include "../Utils/Telemetry.hpp"
 #include <vector>
 #include <string>
 
@@ -31,6 +33,8 @@ public:
     void handleEvent(App& app, const SDL_Event& event) override;
     void update(App& app) override;
     void render(App& app, SDL_Renderer* renderer) override;
+    const char* name() const override { return "Settings"; }
+    void resume(App& app) override {} // Menu items point at live settings; nothing to rebuild
 
 private:
     std::vector<MenuItem> items;
@@ -39,11 +43,13 @@ private:
     // Smooth Selector
     float selectorY = 0.0f;
     float targetSelectorY = 0.0f;
+    float scrollY = 0.0f;
+    static constexpr int visibleItems = 9; // Rows between the title and the footer
 
-    // System Monitor
-    std::string getRAMUsage();
-    std::string getBatteryLevel();
+    // System Monitor (cached samples from App's Telemetry)
+    std::string getRAMUsage(const SystemSample& sample);
+    std::string getBatteryLevel(const SystemSample& sample);
     
     void buildMenu(App& app);
-    void renderText(SDL_Renderer* renderer, TTF_Font* font, const std::string& text, int x, int y, SDL_Color color);
+    void renderText(App& app, SDL_Renderer* renderer, const std::string& text, int x, int y, SDL_Color color, Font font = FontManager::BODY);
 };
@@ -0,0 +1,82 @@
+#include "TasksState.hpp"
+#include "../App.hpp"
+#include "BrowserState.hpp"
+#include "EditorState.hpp"
+#include <algorithm>
+#include <iostream>
+
+void TasksState::enter(App& app) {
+    tasks = app.getTaskIndex().openTasks();
+    selectedIndex = 0;
+    std::cout << "Entered Tasks State (" << tasks.size() << " open)" << std::endl;
+}
+
+void TasksState::exit(App& app) {
+}
+
+void TasksState::handleEvent(App& app, const SDL_Event& event) {
+    if (event.type != SDL_KEYDOWN) return;
+
+    switch (event.key.keysym.sym) {
+        case SDLK_UP:
+            if (!tasks.empty()) {
+                selectedIndex--;
+                if (selectedIndex < 0) selectedIndex = tasks.size() - 1;
+            }
+            break;
+        case SDLK_DOWN:
+            if (!tasks.empty()) {
+                selectedIndex++;
+                if (selectedIndex >= static_cast<int>(tasks.size())) selectedIndex = 0;
+            }
+            break;
+        case SDLK_a: // Open note at the task's line
+        case SDLK_RETURN:
+            if (!tasks.empty()) {
+                const TaskEntry& task = tasks[selectedIndex];
+                auto editor = app.pooledState<EditorState>();
+                editor->open(task.note, false, task.line);
+                app.changeState(editor); // Back from the note goes to the browser
+            }
+            break;
+        case SDLK_ESCAPE: // Back
+        case SDLK_b:
+            app.popState();
+            break;
+    }
+}
+
+void TasksState::update(App& app) {
+}
+
+void TasksState::render(App& app, SDL_Renderer* renderer) {
+    SDL_SetRenderDrawColor(renderer, 20, 20, 30, 255);
+    SDL_RenderClear(renderer);
+
+    renderText(app, renderer, "OPEN TASKS (" + std::to_string(tasks.size()) + ")", 20, 20, {255, 200, 100, 255}, FontManager::HEADER);
+
+    if (tasks.empty()) {
+        renderText(app, renderer, "Nothing open. Enjoy your day.", 40, 200, {100, 100, 100, 255});
+        return;
+    }
+
+    // Keep the selection on screen
+    int lineHeight = 36;
+    int visibleRows = (app.getScreenHeight() - 80) / lineHeight;
+    int first = std::max(0, selectedIndex - visibleRows + 1);
+
+    for (int i = first; i < static_cast<int>(tasks.size()) && i < first + visibleRows; ++i) {
+        const TaskEntry& task = tasks[i];
+        SDL_Color col = {150, 150, 150, 255};
+        if (i == selectedIndex) col = {255, 255, 255, 255};
+        if (task.bulletType == '!') col.g = col.b = (i == selectedIndex) ? 120 : 90;
+
+        int y = 70 + (i - first) * lineHeight;
+        renderText(app, renderer, std::string(1, task.bulletType) + " " + task.text, 40, y, col);
+        renderText(app, renderer, task.note, 420, y, {100, 100, 120, 255});
+    }
+}
+
+void TasksState::renderText(App& app, SDL_Renderer* renderer, const std::string& text, int x, int y, SDL_Color color, Font font) {
+    app.getTextRasterizer().draw(renderer, font, text, color, x, y);
+}
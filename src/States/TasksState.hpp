@@ -0,0 +1,23 @@
+#pragma once
+#include "../State.hpp"
+#include "../Utils/FontManager.hpp"
+#include "../Utils/TaskIndex.hpp"
+#include <vector>
+#include <string>
+
+// Aggregate "Open Tasks" view across all public notes, served from the TaskIndex.
+class TasksState : public State {
+public:
+    void enter(App& app) override;
+    void exit(App& app) override;
+    void handleEvent(App& app, const SDL_Event& event) override;
+    void update(App& app) override;
+    void render(App& app, SDL_Renderer* renderer) override;
+    const char* name() const override { return "Tasks"; }
+
+private:
+    std::vector<TaskEntry> tasks;
+    int selectedIndex = 0;
+
+    void renderText(App& app, SDL_Renderer* renderer, const std::string& text, int x, int y, SDL_Color color, Font font = FontManager::BODY);
+};
@@ -7,15 +7,21 @@ struct AppSettings {
     // Input
     bool useAlphabeticalRibbon = false;
     float lerpStrength = 0.22f; // Default "Premium Feel"
+    bool lateInput = false; // Read buttons just before drawing instead of right after the last frame
 
     // Visuals
     bool stealthMode = false; // Stealth Black vs Classic UI
+    bool showPerfHud = false; // Frame-time/memory overlay in every screen
 
     // Security
-    int decoyScreenIndex = 0; // 0: Fake Update, 1: Error Screen (example)
+    int decoyScreenIndex = 0; // 0: Fake Update, 1: Error Screen (example), 2: Black Screen
+    static constexpr int DECOY_SCREEN_COUNT = 3;
 
     // BuJo
     int defaultTemplateIndex = 0; // 0: Rapid Log (Daily), 1: Cornell, 2: Charting
+
+    // Storage
+    bool compressNotes = false; // Public notes on disk; vault notes are always compressed
     
     // File path
     const std::string configPath = "settings.cfg";
@@ -25,9 +31,12 @@ struct AppSettings {
         if (file.is_open()) {
             file << "useAlphabeticalRibbon=" << useAlphabeticalRibbon << "\n";
             file << "lerpStrength=" << lerpStrength << "\n";
+            file << "lateInput=" << lateInput << "\n";
             file << "stealthMode=" << stealthMode << "\n";
+            file << "showPerfHud=" << showPerfHud << "\n";
             file << "decoyScreenIndex=" << decoyScreenIndex << "\n";
             file << "defaultTemplateIndex=" << defaultTemplateIndex << "\n";
+            file << "compressNotes=" << compressNotes << "\n";
             file.close();
         }
     }
@@ -44,9 +53,12 @@ struct AppSettings {
                     
                     if (key == "useAlphabeticalRibbon") useAlphabeticalRibbon = (val == "1");
                     else if (key == "lerpStrength") lerpStrength = std::stof(val);
+                    else if (key == "lateInput") lateInput = (val == "1");
                     else if (key == "stealthMode") stealthMode = (val == "1");
+                    else if (key == "showPerfHud") showPerfHud = (val == "1");
                     else if (key == "decoyScreenIndex") decoyScreenIndex = std::stoi(val);
                     else if (key == "defaultTemplateIndex") defaultTemplateIndex = std::stoi(val);
+                    else if (key == "compressNotes") compressNotes = (val == "1");
                 }
             }
             file.close();
@@ -0,0 +1,301 @@
+#include "BakedFont.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace {
+
+// Layout, little-endian (save(), run by tools/bake_fonts.cpp):
+//   "NPF1", u16 face count, then per face:
+//   u8 name length, name, u16 size, i16 ascent, i16 height, u16 atlas width, u16 atlas height,
+//   GLYPH_COUNT x (i16 left, i16 top, u16 x, u16 y, u16 w, u16 h, i16 advance),
+//   u16 kerning pair count, pairs of (u8 left, u8 right, i8 pixels),
+//   atlas width x height coverage bytes
+const char MAGIC[4] = {'N', 'P', 'F', '1'};
+const size_t GLYPH_SIZE = 14;
+
+void put(std::string& out, uint32_t v, int bytes) {
+    for (int i = 0; i < bytes; ++i) out.push_back(static_cast<char>(v >> (8 * i)));
+}
+
+uint32_t get(const std::string& in, size_t pos, int bytes) {
+    uint32_t v = 0;
+    for (int i = 0; i < bytes; ++i) v |= static_cast<uint32_t>(static_cast<uint8_t>(in[pos + i])) << (8 * i);
+    return v;
+}
+
+int getSigned16(const std::string& in, size_t pos) {
+    return static_cast<int16_t>(get(in, pos, 2));
+}
+
+} // namespace
+
+bool BakedFont::load(const std::string& path) {
+    faces.clear();
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) return false;
+    std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (data.size() < sizeof(MAGIC) + 2 || std::memcmp(data.data(), MAGIC, sizeof(MAGIC)) != 0) return false;
+
+    size_t pos = sizeof(MAGIC);
+    size_t count = get(data, pos, 2);
+    pos += 2;
+    std::vector<Face> loaded(count);
+    for (Face& face : loaded) {
+        if (pos + 1 > data.size()) return false;
+        size_t nameLength = get(data, pos, 1);
+        pos += 1;
+        if (pos + nameLength + 10 + GLYPH_COUNT * GLYPH_SIZE + 2 > data.size()) return false;
+        face.name = data.substr(pos, nameLength);
+        pos += nameLength;
+        face.size = get(data, pos, 2);
+        face.ascent = getSigned16(data, pos + 2);
+        face.height = getSigned16(data, pos + 4);
+        face.atlasWidth = get(data, pos + 6, 2);
+        face.atlasHeight = get(data, pos + 8, 2);
+        pos += 10;
+
+        for (Glyph& glyph : face.glyphs) {
+            glyph.present = true;
+            glyph.left = getSigned16(data, pos);
+            glyph.top = getSigned16(data, pos + 2);
+            glyph.x = get(data, pos + 4, 2);
+            glyph.y = get(data, pos + 6, 2);
+            glyph.w = get(data, pos + 8, 2);
+            glyph.h = get(data, pos + 10, 2);
+            glyph.advance = getSigned16(data, pos + 12);
+            pos += GLYPH_SIZE;
+            if (glyph.x + glyph.w > face.atlasWidth || glyph.y + glyph.h > face.atlasHeight) return false;
+        }
+
+        size_t pairs = get(data, pos, 2);
+        pos += 2;
+        if (pos + pairs * 3 > data.size()) return false;
+        face.kerning.assign(GLYPH_COUNT * GLYPH_COUNT, 0);
+        for (size_t i = 0; i < pairs; ++i, pos += 3) {
+            unsigned char left = static_cast<unsigned char>(data[pos]);
+            unsigned char right = static_cast<unsigned char>(data[pos + 1]);
+            if (left < FIRST_GLYPH || left > LAST_GLYPH || right < FIRST_GLYPH || right > LAST_GLYPH) continue;
+            face.kerning[(left - FIRST_GLYPH) * GLYPH_COUNT + (right - FIRST_GLYPH)] = static_cast<int8_t>(data[pos + 2]);
+        }
+
+        size_t atlasBytes = static_cast<size_t>(face.atlasWidth) * face.atlasHeight;
+        if (pos + atlasBytes > data.size()) return false;
+        face.atlas.assign(data.begin() + pos, data.begin() + pos + atlasBytes);
+        pos += atlasBytes;
+    }
+    faces = std::move(loaded);
+    return true;
+}
+
+bool BakedFont::save(const std::string& path) const {
+    std::string out(MAGIC, sizeof(MAGIC));
+    put(out, static_cast<uint32_t>(faces.size()), 2);
+    for (const Face& face : faces) {
+        put(out, static_cast<uint32_t>(face.name.size()), 1);
+        out += face.name;
+        put(out, face.size, 2);
+        put(out, static_cast<uint32_t>(face.ascent), 2);
+        put(out, static_cast<uint32_t>(face.height), 2);
+        put(out, face.atlasWidth, 2);
+        put(out, face.atlasHeight, 2);
+        for (const Glyph& glyph : face.glyphs) {
+            put(out, static_cast<uint32_t>(glyph.left), 2);
+            put(out, static_cast<uint32_t>(glyph.top), 2);
+            put(out, glyph.x, 2);
+            put(out, glyph.y, 2);
+            put(out, glyph.w, 2);
+            put(out, glyph.h, 2);
+            put(out, static_cast<uint32_t>(glyph.advance), 2);
+        }
+        std::string pairs;
+        uint32_t count = 0;
+        for (size_t i = 0; i < face.kerning.size(); ++i) {
+            if (face.kerning[i] == 0) continue;
+            put(pairs, static_cast<uint32_t>(FIRST_GLYPH + i / GLYPH_COUNT), 1);
+            put(pairs, static_cast<uint32_t>(FIRST_GLYPH + i % GLYPH_COUNT), 1);
+            put(pairs, static_cast<uint8_t>(face.kerning[i]), 1);
+            count++;
+        }
+        put(out, count, 2);
+        out += pairs;
+        out.append(face.atlas.begin(), face.atlas.end());
+    }
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(out.data(), out.size());
+    return static_cast<bool>(file);
+}
+
+const BakedFont::Face* BakedFont::find(const std::string& name, int size) const {
+    for (const Face& face : faces) {
+        if (face.name == name && face.size == size) return &face;
+    }
+    return nullptr;
+}
+
+size_t BakedFont::memoryUsage() const {
+    size_t bytes = 0;
+    for (const Face& face : faces) bytes += face.memoryUsage();
+    return bytes;
+}
+
+BakedFont::Face BakedFont::Face::empty(const std::string& name, int size, TTF_Font* font) {
+    Face face;
+    face.name = name;
+    face.size = size;
+    face.ascent = TTF_FontAscent(font);
+    face.height = TTF_FontHeight(font);
+    face.atlasWidth = ATLAS_WIDTH;
+    face.kerning.assign(GLYPH_COUNT * GLYPH_COUNT, 0);
+    return face;
+}
+
+bool BakedFont::Face::bake(TTF_Font* font, unsigned char c) {
+    if (c < FIRST_GLYPH || c > LAST_GLYPH) return false;
+    if (glyph(c).present) return true;
+    Glyph baked;
+    int minx, maxx, miny, maxy;
+    if (TTF_GlyphMetrics(font, c, &minx, &maxx, &miny, &maxy, &baked.advance) != 0) return false;
+
+    // Rendered on its own and cropped to its ink
+    std::vector<uint8_t> coverage;
+    if (c != ' ') {
+        char text[2] = {static_cast<char>(c), '\0'};
+        SDL_Surface* rendered = TTF_RenderText_Blended(font, text, {255, 255, 255, 255});
+        SDL_Surface* surface = rendered ? SDL_ConvertSurfaceFormat(rendered, SDL_PIXELFORMAT_ARGB8888, 0) : nullptr;
+        if (rendered) SDL_FreeSurface(rendered);
+        if (!surface) return false;
+        SDL_LockSurface(surface);
+        auto alphaAt = [&](int x, int y) {
+            const Uint32* row = reinterpret_cast<const Uint32*>(static_cast<const Uint8*>(surface->pixels) + y * surface->pitch);
+            return static_cast<uint8_t>(row[x] >> 24);
+        };
+        int left = surface->w, right = -1, top = surface->h, bottom = -1;
+        for (int y = 0; y < surface->h; ++y) {
+            for (int x = 0; x < surface->w; ++x) {
+                if (!alphaAt(x, y)) continue;
+                left = std::min(left, x);
+                right = std::max(right, x);
+                top = std::min(top, y);
+                bottom = std::max(bottom, y);
+            }
+        }
+        if (right >= 0 && right - left < atlasWidth) {
+            // A glyph that starts left of the pen is drawn shifted right by that much
+            baked.left = left - (minx < 0 ? -minx : 0);
+            baked.top = top;
+            baked.w = right - left + 1;
+            baked.h = bottom - top + 1;
+            for (int y = top; y <= bottom; ++y) {
+                for (int x = left; x <= right; ++x) coverage.push_back(alphaAt(x, y));
+            }
+        }
+        SDL_UnlockSurface(surface);
+        SDL_FreeSurface(surface);
+    }
+
+    // Shelf packing: glyphs are all about a line tall, so rows waste little
+    if (baked.w > 0) {
+        if (shelfX + baked.w > atlasWidth) {
+            shelfX = 0;
+            shelfY += shelfHeight + 1;
+            shelfHeight = 0;
+        }
+        baked.x = shelfX;
+        baked.y = shelfY;
+        shelfX += baked.w + 1;
+        shelfHeight = std::max(shelfHeight, baked.h);
+        if (baked.y + baked.h > atlasHeight) {
+            atlasHeight = baked.y + baked.h;
+            atlas.resize(static_cast<size_t>(atlasWidth) * atlasHeight, 0);
+        }
+        for (int row = 0; row < baked.h; ++row) {
+            std::copy_n(&coverage[static_cast<size_t>(row) * baked.w], baked.w,
+                        &atlas[static_cast<size_t>(baked.y + row) * atlasWidth + baked.x]);
+        }
+    }
+
+    baked.present = true;
+    glyphs[c - FIRST_GLYPH] = baked;
+    for (unsigned char other = FIRST_GLYPH; other <= LAST_GLYPH; ++other) {
+        if (!glyph(other).present) continue;
+        auto clamp = [](int v) { return static_cast<int8_t>(std::max(-128, std::min(127, v))); };
+        kerning[(c - FIRST_GLYPH) * GLYPH_COUNT + (other - FIRST_GLYPH)] = clamp(TTF_GetFontKerningSizeGlyphs(font, c, other));
+        kerning[(other - FIRST_GLYPH) * GLYPH_COUNT + (c - FIRST_GLYPH)] = clamp(TTF_GetFontKerningSizeGlyphs(font, other, c));
+    }
+    return true;
+}
+
+bool BakedFont::Face::covers(const std::string& text) const {
+    return std::all_of(text.begin(), text.end(), [this](char c) {
+        unsigned char u = static_cast<unsigned char>(c);
+        return u >= FIRST_GLYPH && u <= LAST_GLYPH && glyph(u).present;
+    });
+}
+
+int BakedFont::Face::kern(unsigned char left, unsigned char right) const {
+    return kerning[(left - FIRST_GLYPH) * GLYPH_COUNT + (right - FIRST_GLYPH)];
+}
+
+int BakedFont::Face::layout(const std::string& text, int* originX) const {
+    // Glyphs overhanging the start (negative left) push the pen right
+    int pen = 0;
+    int minX = 0;
+    int maxX = 0;
+    unsigned char previous = 0;
+    for (char c : text) {
+        unsigned char u = static_cast<unsigned char>(c);
+        if (previous) pen += kern(previous, u);
+        const Glyph& g = glyph(u);
+        if (g.w > 0) {
+            minX = std::min(minX, pen + g.left);
+            maxX = std::max(maxX, pen + g.left + g.w);
+        }
+        pen += g.advance;
+        previous = u;
+    }
+    maxX = std::max(maxX, pen);
+    *originX = -minX;
+    return maxX - minX;
+}
+
+void BakedFont::Face::measure(const std::string& text, int* w, int* h) const {
+    int originX;
+    *w = text.empty() ? 0 : layout(text, &originX);
+    *h = height;
+}
+
+SDL_Surface* BakedFont::Face::render(const std::string& text, SDL_Color color) const {
+    if (text.empty()) return nullptr;
+    int originX;
+    int width = std::max(1, layout(text, &originX));
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_ARGB8888);
+    if (!surface) return nullptr;
+    SDL_memset(surface->pixels, 0, static_cast<size_t>(surface->pitch) * surface->h);
+
+    const Uint32 rgb = (Uint32(color.r) << 16) | (Uint32(color.g) << 8) | color.b;
+    int pen = originX;
+    unsigned char previous = 0;
+    for (char c : text) {
+        unsigned char u = static_cast<unsigned char>(c);
+        if (previous) pen += kern(previous, u);
+        const Glyph& g = glyph(u);
+        for (int row = 0; row < g.h; ++row) {
+            int y = g.top + row;
+            if (y < 0 || y >= height) continue;
+            Uint32* out = reinterpret_cast<Uint32*>(static_cast<Uint8*>(surface->pixels) + y * surface->pitch);
+            const uint8_t* in = &atlas[static_cast<size_t>(g.y + row) * atlasWidth + g.x];
+            for (int col = 0; col < g.w; ++col) {
+                int x = pen + g.left + col;
+                if (x < 0 || x >= width || !in[col]) continue;
+                // Where kerned glyphs overlap, the stronger coverage wins
+                Uint32 alpha = in[col] * color.a / 255;
+                if (alpha > (out[x] >> 24)) out[x] = (alpha << 24) | rgb;
+            }
+        }
+        pen += g.advance;
+        previous = u;
+    }
+    return surface;
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Glyphs pre-rasterized at build time (tools/bake_fonts.cpp, run by `make fonts`):
+// printable ASCII of each font at the sizes the app draws at, one 8-bit
+// coverage atlas plus metrics and kerning per face, in assets/fonts/baked.npf.
+// A string made only of baked glyphs is composed from the atlas, so drawing
+// it never opens SDL_ttf; anything else still needs the TTF.
+// Faces for other sizes are built the same way at run time, a glyph at a time.
+class BakedFont {
+public:
+    static constexpr unsigned char FIRST_GLYPH = ' ';
+    static constexpr unsigned char LAST_GLYPH = '~';
+    static constexpr int GLYPH_COUNT = LAST_GLYPH - FIRST_GLYPH + 1;
+    static constexpr int ATLAS_WIDTH = 256; // Atlases grow downwards only
+
+    struct Glyph {
+        bool present = false;
+        int left = 0;    // Bitmap offset from the pen position
+        int top = 0;     // Bitmap offset from the top of the line
+        int x = 0, y = 0, w = 0, h = 0; // In the atlas; 0x0 for blank glyphs (space)
+        int advance = 0;
+    };
+
+    struct Face {
+        std::string name; // Font file name without .ttf, e.g. "default"
+        int size = 0;
+        int ascent = 0;
+        int height = 0;   // As TTF_FontHeight
+        int atlasWidth = 0;
+        int atlasHeight = 0;
+        Glyph glyphs[GLYPH_COUNT];
+        std::vector<int8_t> kerning;  // GLYPH_COUNT x GLYPH_COUNT, by (left, right)
+        std::vector<uint8_t> atlas;
+
+        // An empty face for font; bake() fills it
+        static Face empty(const std::string& name, int size, TTF_Font* font);
+        // Rasterizes c as TTF_RenderText_Blended would, plus its kerning against the glyphs already here
+        bool bake(TTF_Font* font, unsigned char c);
+
+        bool covers(const std::string& text) const; // Every character is here
+        // Same box TTF_SizeText would give
+        void measure(const std::string& text, int* w, int* h) const;
+        // ARGB8888 with the colour in RGB and coverage in alpha, like TTF_RenderText_Blended
+        SDL_Surface* render(const std::string& text, SDL_Color color) const;
+        size_t memoryUsage() const { return sizeof(Face) + kerning.capacity() + atlas.capacity(); }
+
+    private:
+        int shelfX = 0, shelfY = 0, shelfHeight = 0; // Packing state for bake()
+
+        const Glyph& glyph(unsigned char c) const { return glyphs[c - FIRST_GLYPH]; }
+        int kern(unsigned char left, unsigned char right) const;
+        int layout(const std::string& text, int* originX) const; // Width
+    };
+
+    // False if the file is missing or not a baked font file; the TTF covers everything then
+    bool load(const std::string& path);
+    bool save(const std::string& path) const;
+    void add(Face face) { faces.push_back(std::move(face)); }
+    const Face* find(const std::string& name, int size) const;
+    size_t memoryUsage() const;
+
+private:
+    std::vector<Face> faces;
+};
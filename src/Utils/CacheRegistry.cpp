@@ -0,0 +1,82 @@
+#include "CacheRegistry.hpp"
+#include <algorithm>
+#include <iostream>
+
+void CacheRegistry::add(const std::string& name, int priority, MemoryPressure firstStage,
+                        std::function<size_t()> cost, Evictor evict) {
+    Cache cache{name, priority, firstStage, std::move(cost), std::move(evict)};
+    auto at = std::upper_bound(entries.begin(), entries.end(), cache,
+                               [](const Cache& a, const Cache& b) { return a.priority < b.priority; });
+    entries.insert(at, std::move(cache));
+}
+
+MemoryPressure CacheRegistry::levelOf(const SystemSample& sample, MemoryPressure previous) {
+    // Thresholds for the levels already in force are raised by the margins, so
+    // the pressure doesn't flap around a threshold
+    auto margin = [previous](MemoryPressure level) { return previous >= level; };
+    MemoryPressure level = MemoryPressure::NONE;
+    if (sample.memTotalKB > 0 && sample.memAvailableKB >= 0) {
+        long percent = sample.memAvailableKB * 100 / sample.memTotalKB;
+        if (percent < CRITICAL_AVAILABLE_PERCENT + (margin(MemoryPressure::CRITICAL) ? RELEASE_AVAILABLE_PERCENT : 0)) {
+            return MemoryPressure::CRITICAL;
+        }
+        if (percent < LOW_AVAILABLE_PERCENT + (margin(MemoryPressure::LOW) ? RELEASE_AVAILABLE_PERCENT : 0)) {
+            level = MemoryPressure::LOW;
+        }
+    }
+    // Stalls catch a system that is thrashing before MemAvailable says so
+    float stall = sample.memoryStallPercent;
+    if (stall >= CRITICAL_STALL_PERCENT - (margin(MemoryPressure::CRITICAL) ? RELEASE_STALL_PERCENT : 0.0f)) {
+        return MemoryPressure::CRITICAL;
+    }
+    if (stall >= LOW_STALL_PERCENT - (margin(MemoryPressure::LOW) ? RELEASE_STALL_PERCENT : 0.0f)) {
+        level = MemoryPressure::LOW;
+    }
+    return level;
+}
+
+size_t CacheRegistry::shortfallOf(const SystemSample& sample) {
+    if (sample.memTotalKB <= 0 || sample.memAvailableKB < 0) return 0;
+    long targetKB = sample.memTotalKB * (LOW_AVAILABLE_PERCENT + RELEASE_AVAILABLE_PERCENT) / 100;
+    return targetKB > sample.memAvailableKB ? static_cast<size_t>(targetKB - sample.memAvailableKB) * 1024 : 0;
+}
+
+size_t CacheRegistry::evict(MemoryPressure level, size_t shortfall, uint32_t nowMs) {
+    if (level == MemoryPressure::NONE) return 0;
+    size_t released = 0;
+    for (size_t first = 0; first < entries.size();) {
+        // One priority at a time; stop as soon as it has covered the shortfall
+        size_t end = first;
+        while (end < entries.size() && entries[end].priority == entries[first].priority) end++;
+        for (size_t i = first; i < end; ++i) {
+            Cache& cache = entries[i];
+            if (!cache.evict || cache.firstStage > level) continue;
+            bool cooling = cache.evictedLevel >= level && nowMs - cache.evictedAt < EVICT_COOLDOWN_MS;
+            if (cooling) continue;
+            size_t bytes = cache.evict(level);
+            cache.evictedAt = nowMs;
+            cache.evictedLevel = level;
+            if (bytes > 0) {
+                std::cout << "Memory " << nameOf(level) << ": evicted " << bytes / 1024 << "KB from " << cache.name << std::endl;
+            }
+            released += bytes;
+        }
+        if (released > 0 && released >= shortfall) break;
+        first = end;
+    }
+    return released;
+}
+
+size_t CacheRegistry::totalCost() const {
+    size_t total = 0;
+    for (const Cache& cache : entries) total += cache.cost();
+    return total;
+}
+
+const char* CacheRegistry::nameOf(MemoryPressure level) {
+    switch (level) {
+        case MemoryPressure::LOW: return "low";
+        case MemoryPressure::CRITICAL: return "critical";
+        default: return "none";
+    }
+}
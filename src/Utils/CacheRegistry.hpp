@@ -0,0 +1,73 @@
+#pragma once
+#include "Telemetry.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+enum class MemoryPressure {
+    NONE,
+    LOW,      // Free memory is getting scarce: drop what is cheap to rebuild
+    CRITICAL  // Close to the OOM killer: drop everything that can be rebuilt
+};
+
+// Every cache that holds rebuildable data registers here with an estimate of
+// its size, a priority and an eviction callback. App reads the pressure from
+// the telemetry samples (MemAvailable, and PSI where the kernel has it) and
+// evicts in stages: lowest priority first, one priority at a time until the
+// shortfall is covered, and only the caches that belong to the current stage.
+// A cache that was just evicted is left alone for a while so it isn't cleared
+// again as it refills. Main thread only.
+class CacheRegistry {
+public:
+    static constexpr long LOW_AVAILABLE_PERCENT = 15;
+    static constexpr long CRITICAL_AVAILABLE_PERCENT = 7;
+    static constexpr float LOW_STALL_PERCENT = 10.0f;      // Tasks stalled on memory, last 10 s
+    static constexpr float CRITICAL_STALL_PERCENT = 40.0f;
+    // Hysteresis: a level is left only this far past where it was entered
+    static constexpr long RELEASE_AVAILABLE_PERCENT = 3;
+    static constexpr float RELEASE_STALL_PERCENT = 5.0f;
+    static constexpr uint32_t EVICT_COOLDOWN_MS = 10000;
+
+    // Returns the bytes it thinks it released
+    using Evictor = std::function<size_t(MemoryPressure level)>;
+
+    struct Cache {
+        std::string name;
+        int priority;               // Lower is evicted first
+        MemoryPressure firstStage;  // The lowest level at which it is evicted
+        std::function<size_t()> cost;
+        Evictor evict;              // Null: counted but never evicted
+        uint32_t evictedAt = 0;
+        MemoryPressure evictedLevel = MemoryPressure::NONE; // NONE: never evicted
+    };
+
+    void add(const std::string& name, int priority, MemoryPressure firstStage,
+             std::function<size_t()> cost, Evictor evict = nullptr);
+
+    // previous is the level in force, which the sample has to clear by the release margins
+    static MemoryPressure levelOf(const SystemSample& sample, MemoryPressure previous = MemoryPressure::NONE);
+    // Bytes to free to get MemAvailable back past the low threshold and its
+    // release margin; 0 if unknown (PSI pressure, no meminfo)
+    static size_t shortfallOf(const SystemSample& sample);
+
+    // Evicts the caches due at this level a priority at a time, lowest first,
+    // until the bytes released cover shortfall (0: the first priority that
+    // releases anything). Caches evicted at this level or above in the last
+    // EVICT_COOLDOWN_MS are skipped. Returns the bytes released.
+    size_t evict(MemoryPressure level, size_t shortfall, uint32_t nowMs);
+
+    // Testing: report this level instead of what the system says (NONE: back to real readings)
+    void simulate(MemoryPressure level) { simulated = level; }
+    MemoryPressure simulatedLevel() const { return simulated; }
+
+    size_t totalCost() const;
+    const std::vector<Cache>& caches() const { return entries; }
+
+    static const char* nameOf(MemoryPressure level);
+
+private:
+    std::vector<Cache> entries; // Sorted by priority
+    MemoryPressure simulated = MemoryPressure::NONE;
+};
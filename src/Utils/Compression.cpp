@@ -0,0 +1,228 @@
+#include "Compression.hpp"
+#include <cstring>
+#include <vector>
+
+namespace {
+
+const char kMagic[4] = {'N', 'P', 'Z', '1'};
+const size_t kMinMatch = 4;
+const size_t kLastLiterals = 5; // Frame ends in literals so the decoder never over-reads
+const int kHashBits = 12;
+
+void putU32(std::string& s, uint32_t v) {
+    for (int i = 0; i < 4; ++i) s += static_cast<char>(v >> (i * 8));
+}
+
+uint32_t getU32(const char* p) {
+    const uint8_t* u = reinterpret_cast<const uint8_t*>(p);
+    return uint32_t(u[0]) | (uint32_t(u[1]) << 8) | (uint32_t(u[2]) << 16) | (uint32_t(u[3]) << 24);
+}
+
+inline uint32_t read32(const char* p) {
+    uint32_t v;
+    std::memcpy(&v, p, 4);
+    return v;
+}
+
+inline uint32_t hash4(uint32_t v) {
+    return (v * 2654435761u) >> (32 - kHashBits);
+}
+
+void putLength(std::string& out, size_t len) {
+    while (len >= 255) {
+        out += static_cast<char>(255);
+        len -= 255;
+    }
+    out += static_cast<char>(len);
+}
+
+void emitSequence(std::string& out, const char* literals, size_t literalLen, size_t offset, size_t matchLen) {
+    size_t matchCode = matchLen ? matchLen - kMinMatch : 0;
+    uint8_t token = static_cast<uint8_t>((std::min<size_t>(literalLen, 15) << 4) | std::min<size_t>(matchCode, 15));
+    out += static_cast<char>(token);
+    if (literalLen >= 15) putLength(out, literalLen - 15);
+    out.append(literals, literalLen);
+    if (matchLen == 0) return; // Final literal run
+
+    out += static_cast<char>(offset & 0xff);
+    out += static_cast<char>(offset >> 8);
+    if (matchCode >= 15) putLength(out, matchCode - 15);
+}
+
+} // namespace
+
+void Compression::compressBlock(const char* src, size_t len, std::string& out) {
+    std::vector<uint32_t> table(1 << kHashBits, 0xffffffff);
+    size_t anchor = 0;
+    size_t pos = 0;
+
+    if (len > kLastLiterals + kMinMatch) {
+        size_t limit = len - kLastLiterals - kMinMatch;
+        while (pos <= limit) {
+            uint32_t sequence = read32(src + pos);
+            uint32_t h = hash4(sequence);
+            uint32_t candidate = table[h];
+            table[h] = static_cast<uint32_t>(pos);
+
+            if (candidate == 0xffffffff || pos - candidate > 0xffff || read32(src + candidate) != sequence) {
+                pos++;
+                continue;
+            }
+
+            size_t matchLen = kMinMatch;
+            size_t maxLen = len - kLastLiterals - pos;
+            while (matchLen < maxLen && src[candidate + matchLen] == src[pos + matchLen]) matchLen++;
+
+            emitSequence(out, src + anchor, pos - anchor, pos - candidate, matchLen);
+            pos += matchLen;
+            anchor = pos;
+        }
+    }
+
+    emitSequence(out, src + anchor, len - anchor, 0, 0);
+}
+
+bool Compression::decompressBlock(const char* src, size_t len, size_t rawLen, std::string& out) {
+    size_t start = out.size();
+    size_t ip = 0;
+
+    auto readLength = [&](size_t base, size_t& value) {
+        value = base;
+        if (base != 15) return true;
+        while (ip < len) {
+            uint8_t b = static_cast<uint8_t>(src[ip++]);
+            value += b;
+            if (b != 255) return true;
+        }
+        return false;
+    };
+
+    while (ip < len) {
+        uint8_t token = static_cast<uint8_t>(src[ip++]);
+
+        size_t literalLen;
+        if (!readLength(token >> 4, literalLen) || ip + literalLen > len) return false;
+        if (out.size() - start + literalLen > rawLen) return false;
+        out.append(src + ip, literalLen);
+        ip += literalLen;
+        if (ip == len) break; // Final literal run
+
+        if (ip + 2 > len) return false;
+        size_t offset = static_cast<uint8_t>(src[ip]) | (static_cast<uint8_t>(src[ip + 1]) << 8);
+        ip += 2;
+        size_t matchLen;
+        if (!readLength(token & 0x0f, matchLen)) return false;
+        matchLen += kMinMatch;
+
+        size_t produced = out.size() - start;
+        if (offset == 0 || offset > produced || produced + matchLen > rawLen) return false;
+
+        // Byte-wise copy: matches may overlap their own output (runs)
+        size_t from = out.size() - offset;
+        out.resize(out.size() + matchLen);
+        char* dst = &out[0];
+        for (size_t i = 0; i < matchLen; ++i) dst[from + offset + i] = dst[from + i];
+    }
+
+    return out.size() - start == rawLen;
+}
+
+std::string Compression::encodeBlock(const char* src, size_t len) {
+    std::string payload;
+    payload.reserve(len + len / 255 + 16);
+    compressBlock(src, len, payload);
+
+    std::string block;
+    putU32(block, static_cast<uint32_t>(len));
+    if (payload.size() >= len) {
+        putU32(block, static_cast<uint32_t>(len)); // Incompressible: store raw
+        block.append(src, len);
+    } else {
+        putU32(block, static_cast<uint32_t>(payload.size()));
+        block += payload;
+    }
+    return block;
+}
+
+bool Compression::isCompressed(const std::string& data) {
+    return data.size() >= 4 && std::memcmp(data.data(), kMagic, 4) == 0;
+}
+
+std::string Compression::compress(const std::string& input) {
+    Encoder encoder;
+    std::string frame = encoder.begin();
+    frame += encoder.feed(input.data(), input.size());
+    frame += encoder.finish();
+    return frame;
+}
+
+bool Compression::decompress(const std::string& frame, std::string& output) {
+    Decoder decoder;
+    output.clear();
+    return decoder.feed(frame.data(), frame.size(), output) && decoder.finished();
+}
+
+// --- Encoder ---
+
+std::string Compression::Encoder::begin() {
+    return std::string(kMagic, 4);
+}
+
+std::string Compression::Encoder::feed(const char* data, size_t len) {
+    pending.append(data, len);
+    std::string out;
+    size_t offset = 0;
+    while (pending.size() - offset >= BLOCK_SIZE) {
+        out += encodeBlock(pending.data() + offset, BLOCK_SIZE);
+        offset += BLOCK_SIZE;
+    }
+    pending.erase(0, offset);
+    return out;
+}
+
+std::string Compression::Encoder::finish() {
+    std::string out;
+    if (!pending.empty()) out += encodeBlock(pending.data(), pending.size());
+    pending.clear();
+    putU32(out, 0); // End marker
+    putU32(out, 0);
+    return out;
+}
+
+// --- Decoder ---
+
+bool Compression::Decoder::feed(const char* data, size_t len, std::string& output) {
+    if (done) return len == 0;
+    buffer.append(data, len);
+
+    size_t pos = 0;
+    if (!headerSeen) {
+        if (buffer.size() < 4) return true;
+        if (std::memcmp(buffer.data(), kMagic, 4) != 0) return false;
+        headerSeen = true;
+        pos = 4;
+    }
+
+    while (buffer.size() - pos >= 8) {
+        uint32_t rawLen = getU32(buffer.data() + pos);
+        uint32_t storedLen = getU32(buffer.data() + pos + 4);
+        if (rawLen == 0) {
+            done = true;
+            pos += 8;
+            break;
+        }
+        if (rawLen > BLOCK_SIZE || storedLen > rawLen) return false;
+        if (buffer.size() - pos - 8 < storedLen) break; // Wait for the rest of the block
+
+        const char* payload = buffer.data() + pos + 8;
+        if (storedLen == rawLen) {
+            output.append(payload, rawLen);
+        } else if (!decompressBlock(payload, storedLen, rawLen, output)) {
+            return false;
+        }
+        pos += 8 + storedLen;
+    }
+
+    buffer.erase(0, pos);
+    return true;
+}
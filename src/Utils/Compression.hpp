@@ -0,0 +1,48 @@
+#pragma once
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+// LZ4-style byte-aligned LZ77, tuned for decode speed on the Cortex-A7.
+//
+// Frame: "NPZ1" then blocks of  rawLen u32le | storedLen u32le | payload,
+// terminated by a block with rawLen 0. A block whose storedLen equals its
+// rawLen is stored uncompressed. Blocks are independent, so frames can be
+// produced and consumed incrementally (e.g. one vault chunk at a time).
+class Compression {
+public:
+    static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+    static bool isCompressed(const std::string& data);
+    static std::string compress(const std::string& input);
+    // Returns false on a corrupt frame.
+    static bool decompress(const std::string& frame, std::string& output);
+
+    // Incremental frame writer: feed plaintext, collect frame bytes.
+    class Encoder {
+    public:
+        std::string begin();
+        std::string feed(const char* data, size_t len);
+        std::string finish();
+
+    private:
+        std::string pending;
+    };
+
+    // Incremental frame reader: feed frame bytes in any slicing, collect plaintext.
+    class Decoder {
+    public:
+        bool feed(const char* data, size_t len, std::string& output);
+        bool finished() const { return done; }
+
+    private:
+        std::string buffer;
+        bool headerSeen = false;
+        bool done = false;
+    };
+
+private:
+    static void compressBlock(const char* src, size_t len, std::string& out);
+    static bool decompressBlock(const char* src, size_t len, size_t rawLen, std::string& out);
+    static std::string encodeBlock(const char* src, size_t len);
+};
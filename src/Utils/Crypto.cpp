@@ -0,0 +1,376 @@
+#include "Crypto.hpp"
+#include <algorithm>
+#include <cstring>
+#include <random>
+
+#if defined(MIYOO) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define CRYPTO_USE_NEON 1
+#endif
+
+namespace {
+
+inline uint32_t load32(const uint8_t* p) {
+    return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+}
+
+inline void store32(uint8_t* p, uint32_t v) {
+    p[0] = v; p[1] = v >> 8; p[2] = v >> 16; p[3] = v >> 24;
+}
+
+inline void store64(uint8_t* p, uint64_t v) {
+    store32(p, static_cast<uint32_t>(v));
+    store32(p + 4, static_cast<uint32_t>(v >> 32));
+}
+
+inline uint32_t rotl(uint32_t v, int n) { return (v << n) | (v >> (32 - n)); }
+inline uint32_t rotr(uint32_t v, int n) { return (v >> n) | (v << (32 - n)); }
+
+// --- Poly1305 (26-bit limbs, suits 32-bit ARM) ---
+
+struct Poly1305 {
+    uint32_t r[5], s[4], h[5] = {0, 0, 0, 0, 0};
+    uint32_t pad[4];
+    uint8_t buffer[16];
+    size_t buffered = 0;
+
+    explicit Poly1305(const uint8_t key[32]) {
+        r[0] = load32(key + 0) & 0x3ffffff;
+        r[1] = (load32(key + 3) >> 2) & 0x3ffff03;
+        r[2] = (load32(key + 6) >> 4) & 0x3ffc0ff;
+        r[3] = (load32(key + 9) >> 6) & 0x3f03fff;
+        r[4] = (load32(key + 12) >> 8) & 0x00fffff;
+        for (int i = 0; i < 4; ++i) s[i] = r[i + 1] * 5;
+        for (int i = 0; i < 4; ++i) pad[i] = load32(key + 16 + i * 4);
+    }
+
+    void block(const uint8_t* m, uint32_t hibit) {
+        h[0] += load32(m + 0) & 0x3ffffff;
+        h[1] += (load32(m + 3) >> 2) & 0x3ffffff;
+        h[2] += (load32(m + 6) >> 4) & 0x3ffffff;
+        h[3] += (load32(m + 9) >> 6) & 0x3ffffff;
+        h[4] += (load32(m + 12) >> 8) | hibit;
+
+        uint64_t d0 = (uint64_t)h[0] * r[0] + (uint64_t)h[1] * s[3] + (uint64_t)h[2] * s[2] + (uint64_t)h[3] * s[1] + (uint64_t)h[4] * s[0];
+        uint64_t d1 = (uint64_t)h[0] * r[1] + (uint64_t)h[1] * r[0] + (uint64_t)h[2] * s[3] + (uint64_t)h[3] * s[2] + (uint64_t)h[4] * s[1];
+        uint64_t d2 = (uint64_t)h[0] * r[2] + (uint64_t)h[1] * r[1] + (uint64_t)h[2] * r[0] + (uint64_t)h[3] * s[3] + (uint64_t)h[4] * s[2];
+        uint64_t d3 = (uint64_t)h[0] * r[3] + (uint64_t)h[1] * r[2] + (uint64_t)h[2] * r[1] + (uint64_t)h[3] * r[0] + (uint64_t)h[4] * s[3];
+        uint64_t d4 = (uint64_t)h[0] * r[4] + (uint64_t)h[1] * r[3] + (uint64_t)h[2] * r[2] + (uint64_t)h[3] * r[1] + (uint64_t)h[4] * r[0];
+
+        uint32_t c = d0 >> 26; h[0] = d0 & 0x3ffffff;
+        d1 += c; c = d1 >> 26; h[1] = d1 & 0x3ffffff;
+        d2 += c; c = d2 >> 26; h[2] = d2 & 0x3ffffff;
+        d3 += c; c = d3 >> 26; h[3] = d3 & 0x3ffffff;
+        d4 += c; c = d4 >> 26; h[4] = d4 & 0x3ffffff;
+        h[0] += c * 5; c = h[0] >> 26; h[0] &= 0x3ffffff;
+        h[1] += c;
+    }
+
+    void update(const uint8_t* data, size_t len) {
+        if (buffered) {
+            size_t take = std::min(len, 16 - buffered);
+            std::memcpy(buffer + buffered, data, take);
+            buffered += take; data += take; len -= take;
+            if (buffered < 16) return;
+            block(buffer, 1u << 24);
+            buffered = 0;
+        }
+        while (len >= 16) {
+            block(data, 1u << 24);
+            data += 16; len -= 16;
+        }
+        if (len) {
+            std::memcpy(buffer, data, len);
+            buffered = len;
+        }
+    }
+
+    void padTo16() {
+        static const uint8_t zeros[16] = {0};
+        if (buffered) update(zeros, 16 - buffered);
+    }
+
+    void finish(uint8_t tag[16]) {
+        if (buffered) {
+            buffer[buffered] = 1;
+            std::memset(buffer + buffered + 1, 0, 16 - buffered - 1);
+            block(buffer, 0);
+        }
+
+        uint32_t c = h[1] >> 26; h[1] &= 0x3ffffff;
+        h[2] += c; c = h[2] >> 26; h[2] &= 0x3ffffff;
+        h[3] += c; c = h[3] >> 26; h[3] &= 0x3ffffff;
+        h[4] += c; c = h[4] >> 26; h[4] &= 0x3ffffff;
+        h[0] += c * 5; c = h[0] >> 26; h[0] &= 0x3ffffff;
+        h[1] += c;
+
+        // Compute h - p and select it if non-negative (constant time)
+        uint32_t g[5];
+        g[0] = h[0] + 5; c = g[0] >> 26; g[0] &= 0x3ffffff;
+        g[1] = h[1] + c; c = g[1] >> 26; g[1] &= 0x3ffffff;
+        g[2] = h[2] + c; c = g[2] >> 26; g[2] &= 0x3ffffff;
+        g[3] = h[3] + c; c = g[3] >> 26; g[3] &= 0x3ffffff;
+        g[4] = h[4] + c - (1u << 26);
+
+        uint32_t mask = (g[4] >> 31) - 1;
+        for (int i = 0; i < 5; ++i) h[i] = (h[i] & ~mask) | (g[i] & mask);
+
+        uint32_t t0 = h[0] | (h[1] << 26);
+        uint32_t t1 = (h[1] >> 6) | (h[2] << 20);
+        uint32_t t2 = (h[2] >> 12) | (h[3] << 14);
+        uint32_t t3 = (h[3] >> 18) | (h[4] << 8);
+
+        uint64_t f = (uint64_t)t0 + pad[0]; store32(tag + 0, f);
+        f = (uint64_t)t1 + pad[1] + (f >> 32); store32(tag + 4, f);
+        f = (uint64_t)t2 + pad[2] + (f >> 32); store32(tag + 8, f);
+        f = (uint64_t)t3 + pad[3] + (f >> 32); store32(tag + 12, f);
+    }
+};
+
+// --- SHA-256 ---
+
+const uint32_t kSha256K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+struct Sha256 {
+    uint32_t state[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                         0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+    uint8_t buffer[64];
+    size_t buffered = 0;
+    uint64_t total = 0;
+
+    void compress(const uint8_t* p) {
+        uint32_t w[64];
+        for (int i = 0; i < 16; ++i) {
+            w[i] = (uint32_t(p[i * 4]) << 24) | (uint32_t(p[i * 4 + 1]) << 16) |
+                   (uint32_t(p[i * 4 + 2]) << 8) | uint32_t(p[i * 4 + 3]);
+        }
+        for (int i = 16; i < 64; ++i) {
+            uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+        uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+        for (int i = 0; i < 64; ++i) {
+            uint32_t t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + kSha256K[i] + w[i];
+            uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+            h = g; g = f; f = e; e = d + t1;
+            d = c; c = b; b = a; a = t1 + t2;
+        }
+        state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+        state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+    }
+
+    void update(const uint8_t* data, size_t len) {
+        total += len;
+        while (len) {
+            size_t take = std::min(len, 64 - buffered);
+            std::memcpy(buffer + buffered, data, take);
+            buffered += take; data += take; len -= take;
+            if (buffered == 64) {
+                compress(buffer);
+                buffered = 0;
+            }
+        }
+    }
+
+    std::array<uint8_t, 32> finish() {
+        uint64_t bits = total * 8;
+        uint8_t pad = 0x80;
+        update(&pad, 1);
+        uint8_t zero = 0;
+        while (buffered != 56) update(&zero, 1);
+        uint8_t len[8];
+        for (int i = 0; i < 8; ++i) len[i] = bits >> (56 - i * 8);
+        update(len, 8);
+
+        std::array<uint8_t, 32> out;
+        for (int i = 0; i < 8; ++i) {
+            out[i * 4] = state[i] >> 24; out[i * 4 + 1] = state[i] >> 16;
+            out[i * 4 + 2] = state[i] >> 8; out[i * 4 + 3] = state[i];
+        }
+        return out;
+    }
+};
+
+#ifdef CRYPTO_USE_NEON
+#define ROTLQ(v, n) vsriq_n_u32(vshlq_n_u32((v), (n)), (v), 32 - (n))
+#define ROTL16Q(v) vreinterpretq_u32_u16(vrev32q_u16(vreinterpretq_u16_u32(v)))
+#endif
+
+} // namespace
+
+void Crypto::chachaBlock(const uint32_t input[16], uint8_t out[64]) {
+#ifdef CRYPTO_USE_NEON
+    // Row-wise NEON: one quarter-round on all four columns at once, then
+    // rotate rows so the diagonals line up for the second half of the round.
+    const uint32x4_t in0 = vld1q_u32(input), in1 = vld1q_u32(input + 4);
+    const uint32x4_t in2 = vld1q_u32(input + 8), in3 = vld1q_u32(input + 12);
+    uint32x4_t a = in0, b = in1, c = in2, d = in3;
+
+    for (int i = 0; i < 10; ++i) {
+        a = vaddq_u32(a, b); d = veorq_u32(d, a); d = ROTL16Q(d);
+        c = vaddq_u32(c, d); b = veorq_u32(b, c); b = ROTLQ(b, 12);
+        a = vaddq_u32(a, b); d = veorq_u32(d, a); d = ROTLQ(d, 8);
+        c = vaddq_u32(c, d); b = veorq_u32(b, c); b = ROTLQ(b, 7);
+
+        b = vextq_u32(b, b, 1); c = vextq_u32(c, c, 2); d = vextq_u32(d, d, 3);
+
+        a = vaddq_u32(a, b); d = veorq_u32(d, a); d = ROTL16Q(d);
+        c = vaddq_u32(c, d); b = veorq_u32(b, c); b = ROTLQ(b, 12);
+        a = vaddq_u32(a, b); d = veorq_u32(d, a); d = ROTLQ(d, 8);
+        c = vaddq_u32(c, d); b = veorq_u32(b, c); b = ROTLQ(b, 7);
+
+        b = vextq_u32(b, b, 3); c = vextq_u32(c, c, 2); d = vextq_u32(d, d, 1);
+    }
+
+    vst1q_u8(out, vreinterpretq_u8_u32(vaddq_u32(a, in0)));
+    vst1q_u8(out + 16, vreinterpretq_u8_u32(vaddq_u32(b, in1)));
+    vst1q_u8(out + 32, vreinterpretq_u8_u32(vaddq_u32(c, in2)));
+    vst1q_u8(out + 48, vreinterpretq_u8_u32(vaddq_u32(d, in3)));
+#else
+    uint32_t x[16];
+    std::memcpy(x, input, sizeof(x));
+
+#define QR(a, b, c, d) \
+    x[a] += x[b]; x[d] = rotl(x[d] ^ x[a], 16); \
+    x[c] += x[d]; x[b] = rotl(x[b] ^ x[c], 12); \
+    x[a] += x[b]; x[d] = rotl(x[d] ^ x[a], 8);  \
+    x[c] += x[d]; x[b] = rotl(x[b] ^ x[c], 7);
+
+    for (int i = 0; i < 10; ++i) {
+        QR(0, 4, 8, 12) QR(1, 5, 9, 13) QR(2, 6, 10, 14) QR(3, 7, 11, 15)
+        QR(0, 5, 10, 15) QR(1, 6, 11, 12) QR(2, 7, 8, 13) QR(3, 4, 9, 14)
+    }
+#undef QR
+
+    for (int i = 0; i < 16; ++i) store32(out + i * 4, x[i] + input[i]);
+#endif
+}
+
+void Crypto::chacha20(const Key& key, const Nonce& nonce, uint32_t counter, uint8_t* data, size_t len) {
+    uint32_t input[16] = {0x61707865, 0x3320646e, 0x79622d32, 0x6b206574};
+    for (int i = 0; i < 8; ++i) input[4 + i] = load32(key.data() + i * 4);
+    input[12] = counter;
+    for (int i = 0; i < 3; ++i) input[13 + i] = load32(nonce.data() + i * 4);
+
+    uint8_t stream[64];
+    while (len) {
+        chachaBlock(input, stream);
+        size_t n = std::min<size_t>(len, 64);
+        for (size_t i = 0; i < n; ++i) data[i] ^= stream[i];
+        data += n; len -= n;
+        input[12]++;
+    }
+}
+
+void Crypto::poly1305(const uint8_t key[32], const uint8_t* aad, size_t aadLen,
+                      const uint8_t* ct, size_t ctLen, uint8_t tag[16]) {
+    Poly1305 mac(key);
+    mac.update(aad, aadLen);
+    mac.padTo16();
+    mac.update(ct, ctLen);
+    mac.padTo16();
+    uint8_t lengths[16];
+    store64(lengths, aadLen);
+    store64(lengths + 8, ctLen);
+    mac.update(lengths, 16);
+    mac.finish(tag);
+}
+
+std::array<uint8_t, Crypto::TAG_SIZE> Crypto::seal(const Key& key, const Nonce& nonce,
+                                                   const uint8_t* aad, size_t aadLen,
+                                                   uint8_t* data, size_t len) {
+    uint8_t polyKey[64] = {0};
+    chacha20(key, nonce, 0, polyKey, sizeof(polyKey));
+    chacha20(key, nonce, 1, data, len);
+
+    std::array<uint8_t, TAG_SIZE> tag;
+    poly1305(polyKey, aad, aadLen, data, len, tag.data());
+    return tag;
+}
+
+bool Crypto::open(const Key& key, const Nonce& nonce,
+                  const uint8_t* aad, size_t aadLen,
+                  uint8_t* data, size_t len, const uint8_t* tag) {
+    uint8_t polyKey[64] = {0};
+    chacha20(key, nonce, 0, polyKey, sizeof(polyKey));
+
+    uint8_t expected[TAG_SIZE];
+    poly1305(polyKey, aad, aadLen, data, len, expected);
+
+    uint8_t diff = 0;
+    for (size_t i = 0; i < TAG_SIZE; ++i) diff |= expected[i] ^ tag[i];
+    if (diff != 0) return false;
+
+    chacha20(key, nonce, 1, data, len);
+    return true;
+}
+
+std::array<uint8_t, 32> Crypto::sha256(const uint8_t* data, size_t len) {
+    Sha256 ctx;
+    ctx.update(data, len);
+    return ctx.finish();
+}
+
+Crypto::Key Crypto::deriveKey(const std::string& passphrase, const std::string& salt, uint32_t iterations) {
+    // PBKDF2-HMAC-SHA256 with a single output block. The keyed inner/outer
+    // contexts are computed once and copied per iteration.
+    uint8_t block[64] = {0};
+    if (passphrase.size() > 64) {
+        auto digest = sha256(reinterpret_cast<const uint8_t*>(passphrase.data()), passphrase.size());
+        std::memcpy(block, digest.data(), digest.size());
+    } else {
+        std::memcpy(block, passphrase.data(), passphrase.size());
+    }
+
+    uint8_t ipad[64], opad[64];
+    for (int i = 0; i < 64; ++i) {
+        ipad[i] = block[i] ^ 0x36;
+        opad[i] = block[i] ^ 0x5c;
+    }
+    Sha256 inner, outer;
+    inner.update(ipad, 64);
+    outer.update(opad, 64);
+
+    auto hmac = [&](const uint8_t* msg, size_t len) {
+        Sha256 i = inner;
+        i.update(msg, len);
+        auto innerDigest = i.finish();
+        Sha256 o = outer;
+        o.update(innerDigest.data(), innerDigest.size());
+        return o.finish();
+    };
+
+    std::string first = salt;
+    first += std::string("\0\0\0\1", 4);
+    auto u = hmac(reinterpret_cast<const uint8_t*>(first.data()), first.size());
+
+    Key key;
+    std::memcpy(key.data(), u.data(), KEY_SIZE);
+    for (uint32_t n = 1; n < iterations; ++n) {
+        u = hmac(u.data(), u.size());
+        for (size_t i = 0; i < KEY_SIZE; ++i) key[i] ^= u[i];
+    }
+    return key;
+}
+
+std::string Crypto::randomBytes(size_t count) {
+    std::random_device rd;
+    std::string out(count, '\0');
+    for (size_t i = 0; i < count; i += 4) {
+        uint32_t v = rd();
+        for (size_t j = 0; j < 4 && i + j < count; ++j) out[i + j] = static_cast<char>(v >> (j * 8));
+    }
+    return out;
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <array>
+
+// Self-contained primitives for the vault (no OpenSSL on the device):
+// ChaCha20-Poly1305 AEAD (RFC 8439) and PBKDF2-HMAC-SHA256 for key derivation.
+// The ChaCha core uses NEON on the Miyoo build.
+class Crypto {
+public:
+    static constexpr size_t KEY_SIZE = 32;
+    static constexpr size_t NONCE_SIZE = 12;
+    static constexpr size_t TAG_SIZE = 16;
+
+    using Key = std::array<uint8_t, KEY_SIZE>;
+    using Nonce = std::array<uint8_t, NONCE_SIZE>;
+
+    // Encrypts `data` in place and returns the tag.
+    static std::array<uint8_t, TAG_SIZE> seal(const Key& key, const Nonce& nonce,
+                                              const uint8_t* aad, size_t aadLen,
+                                              uint8_t* data, size_t len);
+    // Verifies `tag` and decrypts `data` in place. Returns false (data untouched) on mismatch.
+    static bool open(const Key& key, const Nonce& nonce,
+                     const uint8_t* aad, size_t aadLen,
+                     uint8_t* data, size_t len, const uint8_t* tag);
+
+    static Key deriveKey(const std::string& passphrase, const std::string& salt, uint32_t iterations);
+    static std::string randomBytes(size_t count);
+
+    // Exposed for the micro-benchmarks
+    static void chacha20(const Key& key, const Nonce& nonce, uint32_t counter, uint8_t* data, size_t len);
+    static std::array<uint8_t, 32> sha256(const uint8_t* data, size_t len);
+
+private:
+    static void chachaBlock(const uint32_t input[16], uint8_t out[64]);
+    static void poly1305(const uint8_t key[32], const uint8_t* aad, size_t aadLen,
+                         const uint8_t* ct, size_t ctLen, uint8_t tag[16]);
+};
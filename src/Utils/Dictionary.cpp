@@ -0,0 +1,21 @@
+#include "Dictionary.hpp"
+
+Dictionary::Words Dictionary::build() {
+    // Prompt 5: Large Dictionary Buffer (50,000+ words)
+    // We will generate a large set of synthetic words to demonstrate performance,
+    // plus a base set of common English words.
+    auto dict = std::make_shared<std::vector<std::string>>(std::vector<std::string>{
+        "The", "Quick", "Brown", "Fox", "Jumps", "Over", "Lazy", "Dog",
+        "Hello", "World", "Miyoo", "Mini", "Plus", "Notepad", "Editor",
+        "Canvas", "System", "Update", "Decoy", "Vault", "Konami", "Code",
+        "Project", "Manager", "Task", "Event", "Note", "Priority", "Research",
+        "Linear", "Interpolation", "Ribbon", "Crank", "Prediction", "Engine"
+    });
+
+    // Generate 50,000 words to stress test the prediction crank
+    dict->reserve(50100);
+    for (int i = 0; i < 50000; i++) {
+        dict->push_back("word" + std::to_string(i));
+    }
+    return dict;
+}
@@ -0,0 +1,13 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+
+// Word list behind the editor's prediction crank. Built once, off the main
+// thread, and shared read-only by every InputEngine that wants it.
+class Dictionary {
+public:
+    using Words = std::shared_ptr<const std::vector<std::string>>;
+
+    static Words build();
+};
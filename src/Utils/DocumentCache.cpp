@@ -0,0 +1,67 @@
+#include "DocumentCache.hpp"
+
+size_t CachedDocument::footprint() const {
+    size_t bytes = sizeof(CachedDocument) + savedContent.capacity();
+    // Undo snapshots are full copies of roughly the same size
+    return bytes + NoteFormat::footprint(lines) * (1 + history.depth());
+}
+
+std::string DocumentCache::keyFor(const std::string& filename, bool isVault) {
+    return (isVault ? "v:" : "p:") + filename;
+}
+
+std::shared_ptr<CachedDocument> DocumentCache::take(const std::string& key) {
+    auto it = index.find(key);
+    if (it == index.end()) return nullptr;
+    std::shared_ptr<CachedDocument> document = it->second->document;
+    erase(it->second);
+    return document;
+}
+
+void DocumentCache::put(const std::string& key, std::shared_ptr<CachedDocument> document) {
+    remove(key);
+    size_t cost = document->footprint();
+    if (cost > budget) return; // Would evict everything else for one note
+
+    entries.push_front({key, std::move(document), cost});
+    index[key] = entries.begin();
+    used += cost;
+
+    while (used > budget) erase(std::prev(entries.end()));
+}
+
+void DocumentCache::setModified(const std::string& key, std::time_t modified) {
+    auto it = index.find(key);
+    if (it != index.end()) it->second->document->modified = modified;
+}
+
+void DocumentCache::remove(const std::string& key) {
+    auto it = index.find(key);
+    if (it != index.end()) erase(it->second);
+}
+
+void DocumentCache::removeVault() {
+    for (auto it = entries.begin(); it != entries.end();) {
+        auto next = std::next(it);
+        if (it->key.compare(0, 2, "v:") == 0) erase(it);
+        it = next;
+    }
+}
+
+void DocumentCache::clear() {
+    entries.clear();
+    index.clear();
+    used = 0;
+}
+
+size_t DocumentCache::shrinkTo(size_t bytes) {
+    size_t before = used;
+    while (used > bytes && !entries.empty()) erase(std::prev(entries.end()));
+    return before - used;
+}
+
+void DocumentCache::erase(std::list<Entry>::iterator it) {
+    used -= it->cost;
+    index.erase(it->key);
+    entries.erase(it);
+}
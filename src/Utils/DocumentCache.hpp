@@ -0,0 +1,60 @@
+#pragma once
+#include "NoteFormat.hpp"
+#include "HistoryManager.hpp"
+#include <string>
+#include <list>
+#include <unordered_map>
+#include <memory>
+#include <ctime>
+
+// Everything the editor needs to resume a note exactly where it was left
+struct CachedDocument {
+    std::vector<Line> lines;
+    HistoryManager<std::vector<Line>> history;
+    std::string savedContent; // As last loaded or queued for saving
+    int cursorLine = 0;
+    int scrollLine = 0;
+    int layout = 0;
+    std::time_t modified = 0; // File mtime after our last save; 0 while one is pending
+
+    size_t footprint() const;
+};
+
+// LRU of recently edited notes, owned by App. Reopening a cached note skips
+// the read and parse and keeps its undo history. Entries are charged an
+// estimated byte cost (document plus its history snapshots) against a budget;
+// the least recently used go first. Main thread only.
+class DocumentCache {
+public:
+    explicit DocumentCache(size_t budgetBytes = 8 * 1024 * 1024) : budget(budgetBytes) {}
+
+    static std::string keyFor(const std::string& filename, bool isVault);
+
+    // Removes and returns the entry; the editor owns it until put() back
+    std::shared_ptr<CachedDocument> take(const std::string& key);
+    void put(const std::string& key, std::shared_ptr<CachedDocument> document);
+    void setModified(const std::string& key, std::time_t modified);
+    void remove(const std::string& key);
+    void removeVault(); // On lock: no vault plaintext stays in memory
+    void clear();
+    // Memory pressure: drop the least recently used until at most this much is held.
+    // Returns the bytes released.
+    size_t shrinkTo(size_t bytes);
+
+    size_t memoryUsage() const { return used; }
+    size_t size() const { return entries.size(); }
+
+private:
+    struct Entry {
+        std::string key;
+        std::shared_ptr<CachedDocument> document;
+        size_t cost;
+    };
+
+    std::list<Entry> entries; // Most recent first
+    std::unordered_map<std::string, std::list<Entry>::iterator> index;
+    size_t budget;
+    size_t used = 0;
+
+    void erase(std::list<Entry>::iterator it);
+};
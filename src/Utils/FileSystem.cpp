@@ -1,59 +1,224 @@
 #include "FileSystem.hpp"
+#include "Trace.hpp"
+#include "VaultFile.hpp"
+#include "Compression.hpp"
+#include <algorithm>
 #include <iostream>
+#include <set>
+#include <cerrno>
 #include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 std::string FileSystem::publicPath = "Notes/Public/";
 std::string FileSystem::vaultPath = ".sys_cache/";
+Crypto::Key FileSystem::vaultKey = {};
+std::atomic<bool> FileSystem::vaultKeyLoaded{false};
+std::atomic<bool> FileSystem::compressPublic{false};
+VaultManifest FileSystem::manifest;
+std::recursive_mutex FileSystem::mutex;
+
+static const std::string kSaltFile = ".salt";
+static const std::string kManifestFile = ".manifest";
+static const uint32_t kKdfIterations = 20000; // ~50 ms on the Cortex-A7
+
+namespace {
+
+// Temp files are dot-prefixed so listings never show a half-written note
+std::string tempPathFor(const std::string& path) {
+    std::filesystem::path p(path);
+    return (p.parent_path() / ("." + p.filename().string() + ".tmp")).string();
+}
+
+bool syncPath(const std::string& path, bool directory) {
+    int fd = ::open(path.c_str(), directory ? (O_RDONLY | O_DIRECTORY) : O_RDONLY);
+    if (fd < 0) return false;
+    bool ok = ::fsync(fd) == 0;
+    ::close(fd);
+    return ok;
+}
+
+bool writeTemp(const std::string& tmpPath, const std::string& content) {
+    int fd = ::open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return false;
+
+    const char* data = content.data();
+    size_t left = content.size();
+    bool ok = true;
+    while (left > 0) {
+        ssize_t n = ::write(fd, data, left);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            ok = false;
+            break;
+        }
+        data += n;
+        left -= n;
+    }
+    ok = ok && ::fsync(fd) == 0;
+    ok = (::close(fd) == 0) && ok;
+    return ok;
+}
+
+void removeStaleTempsIn(const std::string& dir) {
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(dir, ec)) {
+        std::string name = entry.path().filename().string();
+        if (name.size() > 5 && name[0] == '.' && name.compare(name.size() - 4, 4, ".tmp") == 0) {
+            std::filesystem::remove(entry.path(), ec);
+        }
+    }
+}
+
+} // namespace
 
 void FileSystem::init() {
     std::filesystem::create_directories(publicPath);
     std::filesystem::create_directories(vaultPath);
 }
 
-std::vector<std::string> FileSystem::listFiles(bool vaultUnlocked) {
-    std::vector<std::string> files;
+void FileSystem::removeStaleTemps() {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    // Leftovers from a save interrupted before its rename; the originals are intact
+    removeStaleTempsIn(publicPath);
+    removeStaleTempsIn(vaultPath);
+}
+
+std::vector<FileEntry> FileSystem::listFiles(bool vaultUnlocked) {
+    TRACE_SCOPE("FileSystem::listFiles");
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::vector<FileEntry> files;
     
     // List Public
     for (const auto& entry : std::filesystem::directory_iterator(publicPath)) {
-        files.push_back(entry.path().filename().string());
+        FileEntry file;
+        file.name = entry.path().filename().string();
+        if (file.name[0] == '.') continue; // Temp files and hidden metadata
+        file.displayName = file.name;
+        struct stat info;
+        if (stat(entry.path().c_str(), &info) == 0) {
+            file.size = info.st_size;
+            file.modified = info.st_mtime;
+        }
+        files.push_back(file);
     }
 
-    // List Vault if unlocked
     if (vaultUnlocked) {
-        for (const auto& entry : std::filesystem::directory_iterator(vaultPath)) {
-            files.push_back("[LOCKED] " + entry.path().filename().string());
-        }
+        std::vector<FileEntry> vault = listVaultFiles();
+        files.insert(files.end(), vault.begin(), vault.end());
     }
 
     return files;
 }
 
-void FileSystem::privatizeFile(const std::string& filename) {
-    std::string sourcePath = publicPath + filename;
-    if (!std::filesystem::exists(sourcePath)) return;
+std::vector<FileEntry> FileSystem::listVaultFiles() {
+    TRACE_SCOPE("FileSystem::listVaultFiles");
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::vector<FileEntry> files;
+    if (!vaultKeyLoaded) return files;
 
-    // Read content
-    std::ifstream inFile(sourcePath);
-    std::stringstream buffer;
-    buffer << inFile.rdbuf();
-    std::string content = buffer.str();
-    inFile.close();
+    // From the manifest, no decryption needed
+    for (const auto& [name, meta] : manifest.all()) {
+        FileEntry file;
+        file.name = name;
+        file.displayName = meta.originalName;
+        file.isVault = true;
+        file.size = meta.size;
+        file.modified = meta.modified;
+        file.preview.text = meta.preview;
+        file.preview.modified = meta.modified;
+        file.preview.valid = true;
+        files.push_back(file);
+    }
+    return files;
+}
 
-    // Encrypt
-    std::string encrypted = xorCipher(content);
+bool FileSystem::privatizeFile(const std::string& filename) {
+    TRACE_SCOPE("FileSystem::privatizeFile");
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::string sourcePath = publicPath + filename;
+    std::error_code ec; // Runs on the IOWorker: nothing here may throw
+    if (!std::filesystem::exists(sourcePath, ec)) return false;
+    if (!vaultKeyLoaded) {
+        std::cout << "Vault is locked, cannot privatize " << filename << std::endl;
+        return false;
+    }
 
     // Generate new name
-    std::string newName = randomHexString(3) + ".dat";
+    std::string newName;
+    do {
+        newName = randomHexString(3) + ".dat";
+    } while (std::filesystem::exists(vaultPath + newName, ec));
     std::string destPath = vaultPath + newName;
 
-    // Write to Vault
-    std::ofstream outFile(destPath);
-    outFile << encrypted;
-    outFile.close();
+    // Stream the note through the compressor and encryptor chunk by chunk.
+    // A note saved compressed is decoded first so the preview and size are plaintext.
+    std::string tmpPath = tempPathFor(destPath);
+    std::ifstream inFile(sourcePath, std::ios::binary);
+    VaultFile::Writer writer(tmpPath, vaultKey);
+    Compression::Encoder encoder;
+    Compression::Decoder decoder;
+    std::vector<char> chunk(VaultFile::CHUNK_SIZE);
+    ManifestEntry meta;
+    meta.originalName = filename;
+    std::string header = encoder.begin();
+    bool ok = writer.write(header.data(), header.size());
+    bool first = true;
+    bool sourceCompressed = false;
+    while (ok && inFile) {
+        inFile.read(chunk.data(), chunk.size());
+        if (inFile.gcount() <= 0) continue;
+        std::string plain(chunk.data(), inFile.gcount());
+        if (first) sourceCompressed = Compression::isCompressed(plain);
+        if (sourceCompressed) {
+            std::string decoded;
+            ok = decoder.feed(plain.data(), plain.size(), decoded);
+            plain.swap(decoded);
+        }
+        if (first) meta.preview = VaultManifest::makePreview(plain);
+        first = false;
+        meta.size += plain.size();
+        std::string frame = encoder.feed(plain.data(), plain.size());
+        ok = ok && writer.write(frame.data(), frame.size());
+    }
+    // A read error or a truncated compressed note ends the loop like EOF does;
+    // sealing what was read and deleting the original would lose the rest
+    bool sourceComplete = inFile.eof() && !inFile.bad() && (!sourceCompressed || decoder.finished());
+    inFile.close();
+    if (ok && !sourceComplete) {
+        std::cerr << "Could not read all of " << filename << std::endl;
+        ok = false;
+    }
+    std::string trailer = encoder.finish();
+    ok = ok && writer.write(trailer.data(), trailer.size());
+    ok = writer.finish() && ok;
+    ok = ok && syncPath(tmpPath, false);
+
+    // The manifest entry goes first, then the vault copy, and only then the
+    // original. A crash before the rename leaves an entry without a file,
+    // which loadManifest drops; one after it leaves both copies, and
+    // loadManifest finishes the job by removing the public one.
+    meta.modified = modifiedTime(filename, false);
+    if (ok) {
+        manifest.set(newName, meta);
+        ok = saveManifest(); // Also syncs the vault directory
+    }
+    if (!ok || ::rename(tmpPath.c_str(), destPath.c_str()) != 0) {
+        std::filesystem::remove(tmpPath, ec);
+        if (manifest.find(newName)) {
+            manifest.remove(newName);
+            saveManifest();
+        }
+        std::cerr << "Failed to privatize " << filename << ", it stays public" << std::endl;
+        return false;
+    }
+    syncPath(vaultPath, true);
 
     // Delete original
-    std::filesystem::remove(sourcePath);
+    std::filesystem::remove(sourcePath, ec);
+    syncPath(publicPath, true);
     std::cout << "File privatized to: " << destPath << std::endl;
+    return true;
 }
 
 std::string FileSystem::randomHexString(int length) {
@@ -79,24 +244,276 @@ std::string FileSystem::xorCipher(const std::string& input) {
 }
 
 std::string FileSystem::readFile(const std::string& filename, bool isVault) {
+    std::string content;
+    readFile(filename, isVault, content);
+    return content;
+}
+
+bool FileSystem::readFile(const std::string& filename, bool isVault, std::string& content) {
+    TRACE_SCOPE("FileSystem::readFile");
+    std::lock_guard<std::recursive_mutex> lock(mutex);
     std::string path = (isVault ? vaultPath : publicPath) + filename;
-    std::ifstream inFile(path);
+    content.clear();
+
+    if (isVault && VaultFile::isVaultFormat(path)) {
+        if (!vaultKeyLoaded) return false;
+        VaultFile::Reader reader(path, vaultKey);
+        std::string plain, chunk;
+        while (reader.next(chunk)) plain += chunk;
+        if (reader.failed()) {
+            std::cerr << "Vault note failed authentication: " << filename << std::endl;
+            return false;
+        }
+        content = inflate(plain, filename);
+        return true;
+    }
+
+    std::ifstream inFile(path, std::ios::binary);
+    if (!inFile) return false;
     std::stringstream buffer;
     buffer << inFile.rdbuf();
-    std::string content = buffer.str();
     
     if (isVault) {
-        return xorCipher(content);
+        // Notes privatized before the chunked format; re-encrypted on next save
+        content = xorCipher(buffer.str());
+        return true;
+    }
+    content = inflate(buffer.str(), filename);
+    return true;
+}
+
+std::string FileSystem::inflate(const std::string& stored, const std::string& filename) {
+    if (!Compression::isCompressed(stored)) return stored; // Written before compression, or left plain
+    std::string content;
+    if (!Compression::decompress(stored, content)) {
+        // A plain note that happens to start with the magic stays readable
+        std::cerr << "Corrupt compressed note, showing raw bytes: " << filename << std::endl;
+        return stored;
     }
     return content;
 }
 
 void FileSystem::saveFile(const std::string& filename, const std::string& content, bool isVault) {
+    saveFiles({{filename, content, isVault}});
+}
+
+void FileSystem::saveFiles(const std::vector<PendingWrite>& writes) {
+    TRACE_SCOPE("FileSystem::saveFiles");
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+
+    struct Staged {
+        std::string tmpPath;
+        std::string path;
+    };
+    std::vector<Staged> staged;
+    std::set<std::string> dirs;
+    bool manifestChanged = false;
+
+    // 1. Write and fsync every temp file
+    for (const auto& write : writes) {
+        if (write.isVault && !vaultKeyLoaded) continue;
+        std::string path = (write.isVault ? vaultPath : publicPath) + write.filename;
+        std::string tmpPath = tempPathFor(path);
+
+        bool ok = write.isVault ? writeVaultTemp(tmpPath, write.content)
+                                : writeTemp(tmpPath, compressPublic ? Compression::compress(write.content) : write.content);
+        if (!ok) {
+            std::error_code ec;
+            std::filesystem::remove(tmpPath, ec);
+            std::cerr << "Failed to save note: " << write.filename << std::endl;
+            continue;
+        }
+        staged.push_back({tmpPath, path});
+        dirs.insert(write.isVault ? vaultPath : publicPath);
+
+        if (write.isVault) {
+            updateManifestEntry(write.filename, write.content);
+            manifestChanged = true;
+        }
+    }
+
+    if (manifestChanged) {
+        std::string path = vaultPath + kManifestFile;
+        std::string tmpPath = tempPathFor(path);
+        if (writeVaultTemp(tmpPath, manifest.serialize())) {
+            staged.push_back({tmpPath, path});
+        } else {
+            std::error_code ec;
+            std::filesystem::remove(tmpPath, ec);
+            std::cerr << "Failed to write vault manifest" << std::endl;
+        }
+    }
+
+    // 2. Atomically swap them in
+    for (const auto& file : staged) {
+        if (std::rename(file.tmpPath.c_str(), file.path.c_str()) != 0) {
+            std::cerr << "Failed to replace " << file.path << std::endl;
+        }
+    }
+
+    // 3. One directory sync per directory makes all the renames durable
+    for (const auto& dir : dirs) syncPath(dir, true);
+}
+
+bool FileSystem::writeFileAtomic(const std::string& path, const std::string& content) {
+    TRACE_SCOPE("FileSystem::writeFileAtomic");
+    std::string tmpPath = tempPathFor(path);
+    if (!writeTemp(tmpPath, content) || std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        std::error_code ec;
+        std::filesystem::remove(tmpPath, ec);
+        return false;
+    }
+    std::string dir = std::filesystem::path(path).parent_path().string();
+    syncPath(dir.empty() ? "." : dir, true);
+    return true;
+}
+
+bool FileSystem::writeVaultTemp(const std::string& tmpPath, const std::string& plaintext) {
+    // Compress before encrypting: ciphertext doesn't compress, and fewer bytes to seal
+    std::string frame = Compression::compress(plaintext);
+    VaultFile::Writer writer(tmpPath, vaultKey);
+    writer.write(frame.data(), frame.size());
+    return writer.finish() && syncPath(tmpPath, false);
+}
+
+void FileSystem::updateManifestEntry(const std::string& vaultName, const std::string& content) {
+    ManifestEntry meta;
+    if (const ManifestEntry* existing = manifest.find(vaultName)) meta = *existing;
+    if (meta.originalName.empty()) meta.originalName = vaultName;
+    meta.size = content.size();
+    meta.modified = std::time(nullptr);
+    meta.preview = VaultManifest::makePreview(content);
+    manifest.set(vaultName, meta);
+}
+
+bool FileSystem::exists(const std::string& filename, bool isVault) {
+    return std::filesystem::exists((isVault ? vaultPath : publicPath) + filename);
+}
+
+std::time_t FileSystem::modifiedTime(const std::string& filename, bool isVault) {
     std::string path = (isVault ? vaultPath : publicPath) + filename;
-    std::ofstream outFile(path);
-    if (isVault) {
-        outFile << xorCipher(content);
-    } else {
-        outFile << content;
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0) return 0;
+    return info.st_mtime;
+}
+
+bool FileSystem::unlockVault(const std::string& passphrase) {
+    TRACE_SCOPE("FileSystem::unlockVault");
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::string saltPath = vaultPath + kSaltFile;
+    std::string salt;
+
+    std::ifstream saltIn(saltPath, std::ios::binary);
+    if (saltIn.is_open()) {
+        std::stringstream buffer;
+        buffer << saltIn.rdbuf();
+        salt = buffer.str();
+    }
+    if (salt.size() != 16) {
+        salt = Crypto::randomBytes(16);
+        // Losing the salt loses the vault, so it gets the durable path too
+        writeFileAtomic(saltPath, salt);
+    }
+
+    Crypto::Key key = Crypto::deriveKey(passphrase, salt, kKdfIterations);
+    bool fresh = false;
+    if (!verifyKey(key, fresh)) {
+        key.fill(0);
+        return false;
+    }
+    vaultKey = key;
+    key.fill(0);
+    vaultKeyLoaded = true;
+    loadManifest();
+    // A new vault: the (empty) manifest ties it to this passphrase from now on
+    if (fresh) saveManifest();
+    return true;
+}
+
+bool FileSystem::verifyKey(const Crypto::Key& key, bool& fresh) {
+    // The manifest if there is one, else any note: the first chunk authenticates or it doesn't
+    std::string sample = vaultPath + kManifestFile;
+    if (!VaultFile::isVaultFormat(sample)) {
+        sample.clear();
+        std::error_code ec;
+        for (const auto& entry : std::filesystem::directory_iterator(vaultPath, ec)) {
+            std::string name = entry.path().filename().string();
+            if (name[0] != '.' && VaultFile::isVaultFormat(entry.path().string())) {
+                sample = entry.path().string();
+                break;
+            }
+        }
+    }
+    fresh = sample.empty();
+    if (fresh) return true;
+
+    VaultFile::Reader reader(sample, key);
+    std::string chunk;
+    reader.next(chunk);
+    return !reader.failed();
+}
+
+void FileSystem::lockVault() {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    vaultKey.fill(0);
+    vaultKeyLoaded = false;
+    manifest.clear();
+}
+
+void FileSystem::loadManifest() {
+    TRACE_SCOPE("FileSystem::loadManifest");
+    manifest.parse(readFile(kManifestFile, true));
+
+    // Reconcile with the directory: names only, nothing is decrypted here
+    bool changed = false;
+    std::vector<std::string> present;
+    for (const auto& entry : std::filesystem::directory_iterator(vaultPath)) {
+        std::string name = entry.path().filename().string();
+        if (name[0] == '.') continue;
+        present.push_back(name);
+        if (!manifest.find(name)) {
+            // Privatized before the manifest existed
+            ManifestEntry meta;
+            meta.originalName = name;
+            meta.size = entry.file_size();
+            meta.modified = modifiedTime(name, true);
+            manifest.set(name, meta);
+            changed = true;
+        }
+    }
+    std::vector<std::string> stale;
+    for (const auto& [name, meta] : manifest.all()) {
+        if (std::find(present.begin(), present.end(), name) == present.end()) stale.push_back(name);
+    }
+    for (const auto& name : stale) manifest.remove(name);
+
+    // A privatize killed before it removed the original: finish it. Only an
+    // identical note goes; a new one that took the name stays.
+    for (const auto& [name, meta] : manifest.all()) {
+        std::error_code ec;
+        if (!std::filesystem::exists(publicPath + meta.originalName, ec)) continue;
+        std::string publicContent, vaultContent;
+        if (!readFile(meta.originalName, false, publicContent) || publicContent.size() != meta.size) continue;
+        if (!readFile(name, true, vaultContent) || vaultContent != publicContent) continue;
+        std::filesystem::remove(publicPath + meta.originalName, ec);
+        syncPath(publicPath, true);
+        std::cout << "Finished privatizing " << meta.originalName << std::endl;
+    }
+
+    if (changed || !stale.empty()) saveManifest();
+}
+
+bool FileSystem::saveManifest() {
+    TRACE_SCOPE("FileSystem::saveManifest");
+    // Write a complete new manifest, then swap it in so a crash never leaves a torn one
+    std::string path = vaultPath + kManifestFile;
+    std::string tmpPath = tempPathFor(path);
+    if (!writeVaultTemp(tmpPath, manifest.serialize()) || std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        std::error_code ec;
+        std::filesystem::remove(tmpPath, ec);
+        std::cerr << "Failed to write vault manifest" << std::endl;
+        return false;
     }
+    syncPath(vaultPath, true);
+    return true;
 }
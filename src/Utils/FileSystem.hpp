@@ -6,19 +6,88 @@
 #include <sstream>
 #include <random>
 #include <iomanip>
+#include <ctime>
+#include <mutex>
+#include <atomic>
+#include "Crypto.hpp"
+#include "VaultManifest.hpp"
 
+// Summary shown under a note in the browser, computed without opening it there
+struct NotePreview {
+    std::string text;         // First non-empty line, truncated
+    int lines = -1;           // -1: counts unknown (vault notes)
+    int openTasks = 0;
+    int doneTasks = 0;
+    std::time_t modified = 0; // mtime of the content it was computed from
+    bool valid = false;
+};
+
+struct FileEntry {
+    std::string name;        // On-disk name (randomized inside the vault)
+    std::string displayName; // Original name, as typed and filtered on (the browser marks vault rows)
+    bool isVault = false;
+    uintmax_t size = 0;
+    std::time_t modified = 0;
+    NotePreview preview;
+};
+
+struct PendingWrite {
+    std::string filename;
+    std::string content;
+    bool isVault = false;
+};
+
+// All entry points are safe to call from the IOWorker thread; vault key and
+// manifest access is serialized internally.
 class FileSystem {
 public:
-    static void init();
-    static std::vector<std::string> listFiles(bool vaultUnlocked);
-    static void privatizeFile(const std::string& filename);
-    static std::string readFile(const std::string& filename, bool isVault);
+    static void init(); // Creates the directories; cheap, runs before the first frame
+    static void removeStaleTemps(); // Walks both directories: run it on the IOWorker, before any save
+    static std::vector<FileEntry> listFiles(bool vaultUnlocked);
+    static std::vector<FileEntry> listVaultFiles(); // Manifest only, empty while locked
+    static const std::string& publicDirectory() { return publicPath; }
+    static const std::string& vaultDirectory() { return vaultPath; }
+    static bool privatizeFile(const std::string& filename);
+    static std::string readFile(const std::string& filename, bool isVault); // Empty if unreadable
+    // False if the note can't be opened or (vault) fails authentication or the vault is locked
+    static bool readFile(const std::string& filename, bool isVault, std::string& content);
     static void saveFile(const std::string& filename, const std::string& content, bool isVault);
+    // Durable batch save: every note goes to a temp file that is fsynced and
+    // renamed over the original, then each touched directory is fsynced once.
+    // A crash at any point leaves either the old or the new version of a note.
+    static void saveFiles(const std::vector<PendingWrite>& writes);
+    // Same temp + fsync + rename sequence for app metadata (indices, caches).
+    static bool writeFileAtomic(const std::string& path, const std::string& content);
+    static bool exists(const std::string& filename, bool isVault);
+    static std::time_t modifiedTime(const std::string& filename, bool isVault);
+
+    // Compress public notes on save. Vault notes are always compressed before
+    // encryption; reads detect the frame either way.
+    static void setCompression(bool enabled) { compressPublic = enabled; }
+
+    // Vault key management. The key is derived from the passphrase and a
+    // per-vault salt and only lives in memory while the vault is unlocked.
+    // False if the passphrase doesn't open the existing vault; the first
+    // passphrase given to an empty vault becomes its passphrase.
+    static bool unlockVault(const std::string& passphrase);
+    static void lockVault();
+    static bool hasVaultKey() { return vaultKeyLoaded; } // Any thread
 
 private:
     static std::string publicPath;
     static std::string vaultPath;
+    static Crypto::Key vaultKey;
+    static std::atomic<bool> vaultKeyLoaded;
+    static std::atomic<bool> compressPublic;
+    static VaultManifest manifest;
+    static std::recursive_mutex mutex;
     
+    static bool verifyKey(const Crypto::Key& key, bool& fresh);
+    static void loadManifest();
+    static bool saveManifest();
+    static bool writeVaultTemp(const std::string& tmpPath, const std::string& plaintext);
+    static void updateManifestEntry(const std::string& vaultName, const std::string& content);
+    static std::string inflate(const std::string& stored, const std::string& filename);
     static std::string randomHexString(int length);
-    static std::string xorCipher(const std::string& input);
+    static std::string xorCipher(const std::string& input); // Legacy vault format (read-only)
 };
@@ -0,0 +1,148 @@
+#include "FontManager.hpp"
+#include "Trace.hpp"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+
+FontManager::~FontManager() {
+    close();
+}
+
+const char* FontManager::fileName(Font::Family family) {
+    switch (family) {
+        case Font::PENMANSHIP: return "KGPerfectPenmanship";
+        case Font::DEFAULT: break;
+    }
+    return "default";
+}
+
+bool FontManager::load(const std::string& path) {
+    directory = path;
+    if (!std::ifstream(directory + fileName(Font::DEFAULT) + ".ttf")) return false;
+    baked.load(directory + "baked.npf");
+    return true;
+}
+
+Font FontManager::scaled(Font font, float scale) {
+    if (scale == 1.0f) return font;
+    int size = static_cast<int>(std::lround(font.size * scale / SIZE_STEP)) * SIZE_STEP;
+    return {font.family, std::max(SIZE_STEP, size)};
+}
+
+FontManager::Size& FontManager::entry(Font font) {
+    auto it = sizes.find(font);
+    if (it == sizes.end()) {
+        it = sizes.emplace(font, Size()).first;
+        it->second.baked = baked.find(fileName(font.family), font.size);
+    }
+    it->second.lastUsed = frame;
+    return it->second;
+}
+
+void FontManager::beginFrame() {
+    frame++;
+    if (frame % SWEEP_INTERVAL_FRAMES != 0) return;
+    for (auto it = sizes.begin(); it != sizes.end();) {
+        Size& size = it->second;
+        if (frame - size.lastUsed <= EVICT_AFTER_FRAMES) {
+            ++it;
+        } else if (size.baked) {
+            drop(size); // Only its TTF; the baked glyphs stay
+            ++it;
+        } else {
+            drop(size);
+            it = sizes.erase(it);
+        }
+    }
+}
+
+const BakedFont::Face* FontManager::atlas(Font font, const std::string& text) {
+    bool ascii = std::all_of(text.begin(), text.end(), [](char c) {
+        unsigned char u = static_cast<unsigned char>(c);
+        return u >= BakedFont::FIRST_GLYPH && u <= BakedFont::LAST_GLYPH;
+    });
+    if (!ascii) return nullptr;
+    Size& size = entry(font);
+    if (size.baked) return size.baked;
+
+    if (!size.atlas || !size.atlas->covers(text)) {
+        TTF_Font* source = ttf(font);
+        if (!source) return nullptr;
+        TRACE_SCOPE("FontManager::bake");
+        if (!size.atlas) size.atlas.reset(new BakedFont::Face(BakedFont::Face::empty(fileName(font.family), font.size, source)));
+        for (char c : text) size.atlas->bake(source, static_cast<unsigned char>(c));
+    }
+    return size.atlas->covers(text) ? size.atlas.get() : nullptr;
+}
+
+TTF_Font* FontManager::ttf(Font font) {
+    Size& size = entry(font);
+    if (size.ttf || size.failed) return size.ttf;
+    TRACE_SCOPE("FontManager::open");
+    size.ttf = open(font);
+    if (!size.ttf) {
+        std::cerr << "Failed to load font " << fileName(font.family) << " at " << font.size << "px" << std::endl;
+        size.failed = true;
+    } else {
+        std::cout << "Opened " << fileName(font.family) << ".ttf at " << font.size << "px" << std::endl;
+    }
+    return size.ttf;
+}
+
+int FontManager::lineHeight(Font font) {
+    Size& size = entry(font);
+    if (size.baked) return size.baked->height;
+    if (size.atlas) return size.atlas->height;
+    if (size.ttf) return TTF_FontHeight(size.ttf);
+    return font.size;
+}
+
+size_t FontManager::drop(Size& size) {
+    size_t bytes = size.atlas ? size.atlas->memoryUsage() : 0;
+    size.atlas.reset();
+    if (size.ttf) release(size.ttf);
+    size.ttf = nullptr;
+    size.failed = false;
+    return bytes;
+}
+
+size_t FontManager::evict() {
+    size_t bytes = 0;
+    for (auto it = sizes.begin(); it != sizes.end();) {
+        bytes += drop(it->second);
+        if (it->second.baked) ++it;
+        else it = sizes.erase(it);
+    }
+    return bytes;
+}
+
+size_t FontManager::memoryUsage() const {
+    size_t bytes = baked.memoryUsage();
+    for (const auto& [font, size] : sizes) {
+        if (size.atlas) bytes += size.atlas->memoryUsage();
+    }
+    return bytes;
+}
+
+void FontManager::close() {
+    for (auto& [font, size] : sizes) drop(size);
+    sizes.clear();
+    std::lock_guard<std::mutex> lock(openMutex);
+    if (initializedTtf) TTF_Quit();
+    initializedTtf = false;
+}
+
+TTF_Font* FontManager::open(Font font) {
+    std::lock_guard<std::mutex> lock(openMutex);
+    if (!TTF_WasInit()) {
+        if (TTF_Init() == -1) return nullptr;
+        initializedTtf = true;
+    }
+    return TTF_OpenFont((directory + fileName(font.family) + ".ttf").c_str(), font.size);
+}
+
+void FontManager::release(TTF_Font* font) {
+    std::lock_guard<std::mutex> lock(openMutex);
+    TTF_CloseFont(font);
+}
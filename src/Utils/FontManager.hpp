@@ -0,0 +1,85 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include "BakedFont.hpp"
+
+// A font file at a pixel size; cached text is keyed by it
+struct Font {
+    enum Family : uint8_t { DEFAULT, PENMANSHIP };
+    Family family = DEFAULT;
+    int size = 20;
+
+    bool operator<(const Font& other) const { return std::tie(family, size) < std::tie(other.family, other.size); }
+    bool operator==(const Font& other) const { return family == other.family && size == other.size; }
+    bool operator!=(const Font& other) const { return !(*this == other); }
+};
+
+// Every font and size the app draws with, opened when first drawn. Baked
+// sizes (see BakedFont) cover printable ASCII from the start; any other size
+// gets an atlas of its own, filled a glyph at a time from the TTF as strings
+// need them. The TTFs are only opened for those atlases and for characters
+// outside ASCII. A size nobody has drawn with for a while goes (its atlas and
+// TTF), as does every unbaked size under memory pressure.
+class FontManager {
+public:
+    static constexpr Font BODY = {Font::DEFAULT, 20};
+    static constexpr Font HEADER = {Font::DEFAULT, 24};
+    static constexpr Font SMALL = {Font::DEFAULT, 16};
+    static constexpr Font TINY = {Font::DEFAULT, 14};
+    static constexpr int SIZE_STEP = 2; // Scaled sizes snap to this, so an animation shares a few atlases
+
+    ~FontManager();
+
+    // Reads the baked sizes; opens nothing. False without default.ttf.
+    bool load(const std::string& directory);
+    bool hasBaked() const { return baked.find(fileName(BODY.family), BODY.size) != nullptr; }
+
+    // font at size * scale, snapped to SIZE_STEP
+    static Font scaled(Font font, float scale);
+
+    // Main thread
+    void beginFrame(); // Counts frames, drops idle sizes
+    // font's atlas with every character of text in it, baking what's missing;
+    // null if text has characters outside printable ASCII or the TTF won't open
+    const BakedFont::Face* atlas(Font font, const std::string& text);
+    TTF_Font* ttf(Font font); // The main thread's copy, opened on first use
+    int lineHeight(Font font);
+    size_t evict(); // Every unbaked size; returns the bytes released
+    size_t memoryUsage() const;
+    size_t openSizes() const { return sizes.size(); }
+    void close(); // After the last TTF user: closes the fonts and SDL_ttf
+
+    // Any thread: FreeType face creation and release must be serialized
+    TTF_Font* open(Font font);
+    void release(TTF_Font* font);
+
+private:
+    static constexpr Uint32 EVICT_AFTER_FRAMES = 600; // About ten seconds unused
+    static constexpr Uint32 SWEEP_INTERVAL_FRAMES = 60;
+
+    struct Size {
+        const BakedFont::Face* baked = nullptr;
+        std::unique_ptr<BakedFont::Face> atlas; // Unbaked sizes
+        TTF_Font* ttf = nullptr;
+        bool failed = false; // Don't retry a missing font every frame
+        Uint32 lastUsed = 0;
+    };
+
+    std::string directory;
+    BakedFont baked;
+    std::map<Font, Size> sizes;
+    Uint32 frame = 0;
+
+    std::mutex openMutex;
+    bool initializedTtf = false; // We called TTF_Init, so close() calls TTF_Quit
+
+    Size& entry(Font font);
+    size_t drop(Size& size); // Bytes released
+    static const char* fileName(Font::Family family);
+};
@@ -0,0 +1,157 @@
+#include "FuzzyFilter.hpp"
+#include <algorithm>
+
+namespace {
+
+const int kScoreMatch = 16;
+const int kScoreGapStart = -3;
+const int kScoreGapExtension = -1;
+const int kBonusBoundary = 8;    // Match right after a separator or at the start
+const int kBonusCamel = 7;       // aB, a1
+const int kBonusConsecutive = 4;
+const int kFirstCharMultiplier = 2;
+
+enum class CharClass { SEPARATOR, LOWER, UPPER, DIGIT, OTHER };
+
+CharClass classOf(char c) {
+    // ASCII only: no locale lookups in the per-character loop
+    if (c >= 'a' && c <= 'z') return CharClass::LOWER;
+    if (c >= 'A' && c <= 'Z') return CharClass::UPPER;
+    if (c >= '0' && c <= '9') return CharClass::DIGIT;
+    if (c == ' ' || c == '-' || c == '_' || c == '.' || c == '/' || c == ']') return CharClass::SEPARATOR;
+    return CharClass::OTHER;
+}
+
+int bonusFor(CharClass prev, CharClass cur) {
+    bool word = cur != CharClass::SEPARATOR && cur != CharClass::OTHER;
+    if (!word) return 0;
+    if (prev == CharClass::SEPARATOR || prev == CharClass::OTHER) return kBonusBoundary;
+    if ((prev == CharClass::LOWER && cur == CharClass::UPPER) ||
+        (prev != CharClass::DIGIT && cur == CharClass::DIGIT)) return kBonusCamel;
+    return 0;
+}
+
+inline char fold(char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c + ('a' - 'A')) : c;
+}
+
+} // namespace
+
+std::string FuzzyFilter::foldPattern(const std::string& pattern) {
+    std::string folded;
+    for (char c : pattern) {
+        if (c != ' ') folded += fold(c);
+    }
+    return folded;
+}
+
+int FuzzyFilter::score(const std::string& pattern, const std::string& text) {
+    return scoreFolded(foldPattern(pattern), text);
+}
+
+int FuzzyFilter::scoreFolded(const std::string& pat, const std::string& text) {
+    if (pat.empty()) return 0;
+
+    // 1. Forward scan: leftmost end of an in-order match
+    size_t pi = 0;
+    size_t end = 0;
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (fold(text[i]) == pat[pi] && ++pi == pat.size()) {
+            end = i + 1;
+            break;
+        }
+    }
+    if (pi < pat.size()) return -1;
+
+    // 2. Backward scan: tightest start for that end
+    size_t start = end;
+    pi = pat.size();
+    while (pi > 0) {
+        --start;
+        if (fold(text[start]) == pat[pi - 1]) --pi;
+    }
+
+    // 3. Score the window
+    int total = 0;
+    int consecutive = 0;
+    int firstBonus = 0;
+    bool inGap = false;
+    CharClass prev = start > 0 ? classOf(text[start - 1]) : CharClass::SEPARATOR;
+    pi = 0;
+    for (size_t i = start; i < end; ++i) {
+        CharClass cur = classOf(text[i]);
+        if (pi < pat.size() && fold(text[i]) == pat[pi]) {
+            int bonus = bonusFor(prev, cur);
+            if (consecutive == 0) {
+                firstBonus = bonus;
+            } else {
+                // A run keeps the bonus of the boundary it started on
+                if (bonus >= kBonusBoundary && bonus > firstBonus) firstBonus = bonus;
+                bonus = std::max(bonus, std::max(firstBonus, kBonusConsecutive));
+            }
+            total += kScoreMatch + (pi == 0 ? bonus * kFirstCharMultiplier : bonus);
+            inGap = false;
+            consecutive++;
+            pi++;
+        } else {
+            total += inGap ? kScoreGapExtension : kScoreGapStart;
+            inGap = true;
+            consecutive = 0;
+            firstBonus = 0;
+        }
+        prev = cur;
+    }
+    return total;
+}
+
+void FuzzyFilter::setCandidates(const std::vector<std::string>& list) {
+    candidates = list;
+    everything.clear();
+    everything.reserve(candidates.size());
+    for (size_t i = 0; i < candidates.size(); ++i) everything.push_back({i, 0});
+
+    // Replay the current query over the new candidates
+    std::string query = pattern;
+    clear();
+    for (char c : query) push(c);
+}
+
+void FuzzyFilter::push(char c) {
+    const std::vector<Match>& previous = results();
+    pattern += c;
+
+    std::vector<Match> next;
+    if (c == ' ') {
+        next = previous; // Ignored by the scorer, nothing can drop out
+    } else {
+        // Anything that failed a shorter query can't match a longer one
+        std::string folded = foldPattern(pattern);
+        next.reserve(previous.size());
+        for (const Match& m : previous) {
+            int s = scoreFolded(folded, candidates[m.index]);
+            if (s >= 0) next.push_back({m.index, s});
+        }
+        std::sort(next.begin(), next.end(), [this](const Match& a, const Match& b) {
+            if (a.score != b.score) return a.score > b.score;
+            size_t la = candidates[a.index].size(), lb = candidates[b.index].size();
+            if (la != lb) return la < lb;
+            return a.index < b.index; // Fall back to the list's own order
+        });
+    }
+    levels.push_back(std::move(next));
+}
+
+void FuzzyFilter::pop() {
+    if (pattern.empty()) return;
+    pattern.pop_back();
+    levels.pop_back();
+}
+
+void FuzzyFilter::clear() {
+    pattern.clear();
+    levels.clear();
+}
+
+const std::vector<FuzzyFilter::Match>& FuzzyFilter::results() const {
+    return levels.empty() ? everything : levels.back();
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstddef>
+
+// fzf-style fuzzy filter. A query matches when its characters appear in order
+// (case-insensitive); the score rewards matches at word starts and in runs and
+// penalizes gaps. Each typed character only re-scores the previous result set,
+// kept on a stack so backspace is a pop rather than a full re-filter.
+class FuzzyFilter {
+public:
+    struct Match {
+        size_t index; // Into the candidate list
+        int score;
+    };
+
+    void setCandidates(const std::vector<std::string>& candidates);
+    void push(char c);
+    void pop();
+    void clear(); // Back to the empty query
+
+    const std::string& query() const { return pattern; }
+    // Best match first; every candidate, in order, while the query is empty.
+    const std::vector<Match>& results() const;
+
+    // Score of pattern against text, or -1 if it doesn't match. Spaces in the
+    // pattern are ignored.
+    static int score(const std::string& pattern, const std::string& text);
+
+private:
+    std::vector<std::string> candidates;
+    std::vector<Match> everything;
+    std::vector<std::vector<Match>> levels; // levels[i]: results for pattern[0..i]
+    std::string pattern;
+
+    static std::string foldPattern(const std::string& pattern);
+    static int scoreFolded(const std::string& folded, const std::string& text);
+};
@@ -1,11 +1,14 @@
 #pragma once
 #include <vector>
 #include <deque>
+#include <algorithm>
+#include "Trace.hpp"
 
 template <typename T>
 class HistoryManager {
 public:
     void push(const T& state) {
+        TRACE_SCOPE("HistoryManager::push");
         if (!undoStack.empty() && undoStack.back() == state) return; // Deduplicate
         undoStack.push_back(state);
         if (undoStack.size() > maxHistory) {
@@ -14,6 +17,30 @@ public:
         redoStack.clear();
     }
 
+    void clear() {
+        // Swapped out rather than cleared, so the blocks go back to the heap too
+        std::deque<T>().swap(undoStack);
+        std::vector<T>().swap(redoStack);
+    }
+
+    // Memory budget: forget the oldest undo steps. Returns how many went.
+    size_t dropOldest(size_t count) {
+        count = std::min(count, undoStack.size());
+        undoStack.erase(undoStack.begin(), undoStack.begin() + count);
+        return count;
+    }
+
+    size_t depth() const { return undoStack.size() + redoStack.size(); }
+
+    // Session snapshot: the raw stacks, oldest first
+    const std::deque<T>& undoStates() const { return undoStack; }
+    const std::vector<T>& redoStates() const { return redoStack; }
+    void restore(std::deque<T> undo, std::vector<T> redo) {
+        undoStack = std::move(undo);
+        redoStack = std::move(redo);
+        while (undoStack.size() > maxHistory) undoStack.pop_front();
+    }
+
     bool canUndo() const { return !undoStack.empty(); }
     bool canRedo() const { return !redoStack.empty(); }
 
@@ -46,5 +73,5 @@ public:
 private:
     std::deque<T> undoStack;
     std::vector<T> redoStack;
-    const size_t maxHistory = 100;
+    static constexpr size_t maxHistory = 100;
 };
@@ -0,0 +1,163 @@
+#include "IOWorker.hpp"
+#include "FileSystem.hpp"
+#include "Trace.hpp"
+#include <iostream>
+#include <set>
+
+IOWorker::~IOWorker() {
+    stop();
+}
+
+void IOWorker::start() {
+    if (thread.joinable()) return;
+    eventType = SDL_RegisterEvents(1);
+    stopping = false;
+    thread = std::thread(&IOWorker::loop, this);
+}
+
+void IOWorker::stop() {
+    if (!thread.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    thread.join();
+}
+
+void IOWorker::submit(std::function<void()> job, Completion done) {
+    pending++;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queue.push_back({std::move(job), std::move(done)});
+    }
+    wake.notify_one();
+}
+
+void IOWorker::saveFile(const std::string& filename, const std::string& content, bool isVault, SaveCompletion done) {
+    auto save = std::make_shared<PendingSave>();
+    save->key = (isVault ? "v:" : "p:") + filename;
+    save->filename = filename;
+    save->content = content;
+    save->isVault = isVault;
+    if (done) save->completions.push_back(std::move(done));
+    queueSave(std::move(save));
+}
+
+void IOWorker::saveNewFile(const std::string& filename, const std::string& content, bool isVault, SaveCompletion done) {
+    auto save = std::make_shared<PendingSave>();
+    save->filename = filename;
+    save->content = content;
+    save->isVault = isVault;
+    save->newFile = true;
+    if (done) save->completions.push_back(std::move(done));
+    queueSave(std::move(save));
+}
+
+void IOWorker::queueSave(std::shared_ptr<PendingSave> save) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (save->newFile) save->key = "n:" + std::to_string(newFiles++);
+        auto it = queuedSaves.find(save->key);
+        if (it != queuedSaves.end()) {
+            // Coalesce into the queued save
+            it->second->content = std::move(save->content);
+            for (auto& done : save->completions) it->second->completions.push_back(std::move(done));
+            return;
+        }
+        queuedSaves[save->key] = save;
+        pending++;
+        queue.push_back({nullptr, nullptr, save});
+    }
+    wake.notify_one();
+}
+
+void IOWorker::runSaves(const std::vector<std::shared_ptr<PendingSave>>& batch) {
+    // New notes get their names first; two in one batch mustn't pick the same one
+    std::set<std::string> taken;
+    for (const auto& save : batch) {
+        if (!save->newFile) continue;
+        std::string name = save->filename;
+        size_t dot = name.rfind('.');
+        std::string stem = dot == std::string::npos ? name : name.substr(0, dot);
+        std::string extension = dot == std::string::npos ? "" : name.substr(dot);
+        for (int n = 2; taken.count(name) || FileSystem::exists(name, save->isVault); ++n) {
+            name = stem + "-" + std::to_string(n) + extension;
+        }
+        taken.insert(name);
+        save->filename = name;
+    }
+
+    std::vector<PendingWrite> writes;
+    for (const auto& save : batch) writes.push_back({save->filename, save->content, save->isVault});
+    FileSystem::saveFiles(writes);
+
+    for (const auto& save : batch) {
+        if (saveListener) saveListener(save->filename, save->content, save->isVault);
+        if (save->completions.empty()) continue;
+        std::string filename = save->filename;
+        std::time_t modified = FileSystem::modifiedTime(filename, save->isVault);
+        for (auto& done : save->completions) {
+            postCompletion([done = std::move(done), filename, modified]() { done(filename, modified); });
+        }
+    }
+}
+
+void IOWorker::loop() {
+    TRACE_THREAD("IOWorker");
+    while (true) {
+        Job job;
+        std::vector<std::shared_ptr<PendingSave>> batch;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this]() { return stopping || !queue.empty(); });
+            if (queue.empty()) return; // Stopping and drained
+            job = std::move(queue.front());
+            queue.pop_front();
+
+            if (job.save) {
+                // Take every save queued right behind this one; FIFO order with other jobs is kept
+                batch.push_back(job.save);
+                while (!queue.empty() && queue.front().save) {
+                    batch.push_back(queue.front().save);
+                    queue.pop_front();
+                }
+                // From here on a new save for these notes queues separately
+                for (const auto& save : batch) queuedSaves.erase(save->key);
+            }
+        }
+
+        if (!batch.empty()) {
+            TRACE_SCOPE("IOWorker::saves");
+            runSaves(batch);
+            pending -= static_cast<int>(batch.size());
+            continue;
+        }
+
+        {
+            TRACE_SCOPE("IOWorker::job");
+            job.work();
+        }
+        pending--;
+        if (job.done) postCompletion(std::move(job.done));
+    }
+}
+
+void IOWorker::postCompletion(Completion done) {
+    if (eventType == (Uint32)-1) return;
+    SDL_Event event;
+    SDL_memset(&event, 0, sizeof(event));
+    event.type = eventType;
+    event.user.data1 = new Completion(std::move(done));
+    if (SDL_PushEvent(&event) < 0) {
+        delete static_cast<Completion*>(event.user.data1);
+        std::cerr << "IOWorker: failed to post completion: " << SDL_GetError() << std::endl;
+    }
+}
+
+bool IOWorker::handleEvent(const SDL_Event& event) {
+    if (eventType == (Uint32)-1 || event.type != eventType) return false;
+    std::unique_ptr<Completion> done(static_cast<Completion*>(event.user.data1));
+    if (done && *done) (*done)();
+    return true;
+}
@@ -0,0 +1,95 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <functional>
+#include <future>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <ctime>
+
+// Background thread for all SD-card I/O. Jobs run in FIFO order on the worker;
+// their completions are posted back as SDL user events and run on the main
+// thread from App::run, so states never block on the card.
+class IOWorker {
+public:
+    using Completion = std::function<void()>;
+    // A save's completion: the name the note was saved under and its mtime afterwards
+    using SaveCompletion = std::function<void(const std::string& filename, std::time_t modified)>;
+    // Runs on the worker thread after every successful note save.
+    using SaveListener = std::function<void(const std::string& filename, const std::string& content, bool isVault)>;
+
+    ~IOWorker();
+
+    void start();
+    // Finishes every queued job (pending saves must not be lost), then joins.
+    void stop();
+
+    void submit(std::function<void()> job, Completion done = nullptr);
+
+    // Runs `job` on the worker. The result is available through the future and,
+    // if given, handed to `done` on the main thread.
+    template <typename R>
+    std::future<R> run(std::function<R()> job, std::function<void(const R&)> done = nullptr) {
+        auto promise = std::make_shared<std::promise<R>>();
+        auto result = std::make_shared<R>();
+        std::future<R> future = promise->get_future();
+        submit([job, promise, result]() {
+            *result = job();
+            promise->set_value(*result);
+        }, done ? Completion([done, result]() { done(*result); }) : Completion());
+        return future;
+    }
+
+    // Queues a note save. A save for the same note that hasn't started yet is
+    // replaced by this one, so bursts of saves hit the card once, and
+    // back-to-back saves are committed as one batch sharing directory syncs.
+    void saveFile(const std::string& filename, const std::string& content, bool isVault, SaveCompletion done = nullptr);
+    // A note that has no file yet: saved as `filename`, or as name-2.ext, name-3.ext...
+    // if that is taken. Checked on the worker, so the UI thread never waits on the card.
+    void saveNewFile(const std::string& filename, const std::string& content, bool isVault, SaveCompletion done = nullptr);
+    void setSaveListener(SaveListener listener) { saveListener = std::move(listener); }
+
+    // Main thread: runs the completion carried by a worker event. Returns false for other events.
+    bool handleEvent(const SDL_Event& event);
+
+    bool isBusy() const { return pending.load() > 0; }
+    int pendingCount() const { return pending.load(); }
+
+private:
+    struct PendingSave {
+        std::string key;
+        std::string filename;
+        std::string content;
+        bool isVault = false;
+        bool newFile = false; // filename is only the preferred name
+        std::vector<SaveCompletion> completions;
+    };
+
+    struct Job {
+        std::function<void()> work;
+        Completion done;
+        std::shared_ptr<PendingSave> save; // Set for note saves, which are batched
+    };
+
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<Job> queue;
+    std::map<std::string, std::shared_ptr<PendingSave>> queuedSaves; // Not yet started, by note key
+    std::atomic<int> pending{0};
+    uint64_t newFiles = 0; // Keys new-file saves apart; they never coalesce
+    bool stopping = false;
+    Uint32 eventType = (Uint32)-1;
+    SaveListener saveListener;
+
+    void loop();
+    void postCompletion(Completion done);
+    void queueSave(std::shared_ptr<PendingSave> save);
+    void runSaves(const std::vector<std::shared_ptr<PendingSave>>& batch);
+};
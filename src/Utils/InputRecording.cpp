@@ -0,0 +1,91 @@
+#include "InputRecording.hpp"
+#include <cstring>
+#include <iterator>
+
+namespace {
+
+const char MAGIC[4] = {'N', 'P', 'E', '1'};
+const size_t RECORD_SIZE = 4 + 4 + 4 + 4 + 4 + 2 + 1 + 1;
+
+void put(std::string& out, uint32_t v, int bytes) {
+    for (int i = 0; i < bytes; ++i) out.push_back(static_cast<char>(v >> (8 * i)));
+}
+
+uint32_t get(const std::string& in, size_t pos, int bytes) {
+    uint32_t v = 0;
+    for (int i = 0; i < bytes; ++i) v |= static_cast<uint32_t>(static_cast<uint8_t>(in[pos + i])) << (8 * i);
+    return v;
+}
+
+} // namespace
+
+bool InputRecorder::open(const std::string& path) {
+    file.open(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) return false;
+    file.write(MAGIC, sizeof(MAGIC));
+    return static_cast<bool>(file);
+}
+
+bool InputRecorder::isRecordable(const SDL_Event& event) {
+    return event.type == SDL_KEYDOWN || event.type == SDL_KEYUP || event.type == SDL_QUIT;
+}
+
+void InputRecorder::record(uint32_t frame, uint32_t ms, const SDL_Event& event) {
+    if (!file.is_open() || !isRecordable(event)) return;
+    bool key = event.type != SDL_QUIT;
+    std::string record;
+    put(record, frame, 4);
+    put(record, ms, 4);
+    put(record, event.type, 4);
+    put(record, key ? static_cast<uint32_t>(event.key.keysym.scancode) : 0, 4);
+    put(record, key ? static_cast<uint32_t>(event.key.keysym.sym) : 0, 4);
+    put(record, key ? event.key.keysym.mod : 0, 2);
+    put(record, key ? event.key.repeat : 0, 1);
+    put(record, key ? event.key.state : 0, 1);
+    file.write(record.data(), record.size());
+}
+
+void InputRecorder::close() {
+    if (file.is_open()) file.close();
+}
+
+bool InputReplay::load(const std::string& path) {
+    events.clear();
+    next = 0;
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) return false;
+    std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (data.size() < sizeof(MAGIC) || std::memcmp(data.data(), MAGIC, sizeof(MAGIC)) != 0) return false;
+
+    // A recording cut short by a kill just ends at its last whole record
+    for (size_t pos = sizeof(MAGIC); pos + RECORD_SIZE <= data.size(); pos += RECORD_SIZE) {
+        RecordedEvent recorded;
+        recorded.frame = get(data, pos, 4);
+        recorded.ms = get(data, pos + 4, 4);
+        SDL_Event& event = recorded.event;
+        SDL_memset(&event, 0, sizeof(event));
+        event.type = get(data, pos + 8, 4);
+        if (event.type == SDL_KEYDOWN || event.type == SDL_KEYUP) {
+            event.key.keysym.scancode = static_cast<SDL_Scancode>(get(data, pos + 12, 4));
+            event.key.keysym.sym = static_cast<SDL_Keycode>(get(data, pos + 16, 4));
+            event.key.keysym.mod = static_cast<Uint16>(get(data, pos + 20, 2));
+            event.key.repeat = static_cast<Uint8>(get(data, pos + 22, 1));
+            event.key.state = static_cast<Uint8>(get(data, pos + 23, 1));
+        } else if (event.type != SDL_QUIT) {
+            continue;
+        }
+        events.push_back(recorded);
+    }
+    return true;
+}
+
+std::vector<SDL_Event> InputReplay::takeDue(uint32_t frame, uint32_t elapsedMs, bool byFrame) {
+    std::vector<SDL_Event> due;
+    while (next < events.size()) {
+        const RecordedEvent& recorded = events[next];
+        if (byFrame ? recorded.frame > frame : recorded.ms > elapsedMs) break;
+        due.push_back(recorded.event);
+        next++;
+    }
+    return due;
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Recorded input sessions (--record / --replay). Only what the app reacts to
+// is kept: key presses/releases and quit. The file is "NPE1" followed by
+// fixed-size little-endian records:
+//   frame u32 | ms u32 | type u32 | scancode i32 | sym i32 | mod u16 | repeat u8 | pressed u8
+// frame and ms count from the start of the session, which is when startup
+// (including its background loads) has finished, both when recording and
+// when replaying, so input lands on the same screen either way.
+struct RecordedEvent {
+    uint32_t frame = 0;
+    uint32_t ms = 0;
+    SDL_Event event;
+};
+
+class InputRecorder {
+public:
+    bool open(const std::string& path);
+    bool isOpen() const { return file.is_open(); }
+    void record(uint32_t frame, uint32_t ms, const SDL_Event& event);
+    void close();
+
+    static bool isRecordable(const SDL_Event& event);
+
+private:
+    std::ofstream file;
+};
+
+class InputReplay {
+public:
+    bool load(const std::string& path);
+    bool finished() const { return next >= events.size(); }
+    size_t size() const { return events.size(); }
+
+    // Events due by this frame (max speed) or by this many ms since the
+    // replay started (real time), in recorded order
+    std::vector<SDL_Event> takeDue(uint32_t frame, uint32_t elapsedMs, bool byFrame);
+
+private:
+    std::vector<RecordedEvent> events;
+    size_t next = 0;
+};
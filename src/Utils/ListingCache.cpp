@@ -0,0 +1,338 @@
+#include "ListingCache.hpp"
+#include "VaultManifest.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+
+// Cache file layout (tab separated):
+//   D <directory stamp>
+//   F <size> <mtime> <name>
+//   P <mtime> <lines> <open> <done> <text>      (preview of the preceding F)
+
+namespace {
+
+// The whole field must be a number; a torn or hand-edited cache is rescanned, not trusted
+bool parseNumber(const std::string& field, long long min, long long max, long long& value) {
+    if (field.empty()) return false;
+    char* end = nullptr;
+    errno = 0;
+    value = std::strtoll(field.c_str(), &end, 10);
+    return errno == 0 && *end == '\0' && value >= min && value <= max;
+}
+
+} // namespace
+
+ListingCache::~ListingCache() {
+    if (watchFd >= 0) ::close(watchFd);
+}
+
+void ListingCache::load() {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    // Watch before reading so nothing that happens in between is missed
+    startWatch();
+
+    files.clear();
+    int64_t stamp = -1;
+    std::ifstream file(cachePath);
+    if (file.is_open()) {
+        std::string record;
+        FileEntry* current = nullptr;
+        while (std::getline(file, record)) {
+            if (record.empty()) continue;
+            std::vector<std::string> fields;
+            std::stringstream ss(record);
+            std::string field;
+            while (std::getline(ss, field, '\t')) fields.push_back(field);
+
+            long long number[4] = {};
+            if (fields.size() >= 2 && fields[0] == "D" && parseNumber(fields[1], LLONG_MIN, LLONG_MAX, number[0])) {
+                stamp = number[0];
+            } else if (fields.size() >= 4 && fields[0] == "F" && !fields[3].empty() &&
+                       parseNumber(fields[1], 0, LLONG_MAX, number[0]) &&
+                       parseNumber(fields[2], LLONG_MIN, LLONG_MAX, number[1])) {
+                FileEntry entry;
+                entry.name = fields[3];
+                entry.displayName = entry.name;
+                entry.size = static_cast<uintmax_t>(number[0]);
+                entry.modified = static_cast<std::time_t>(number[1]);
+                current = &(files[entry.name] = entry);
+            } else if (fields.size() >= 5 && fields[0] == "P" && current &&
+                       parseNumber(fields[1], LLONG_MIN, LLONG_MAX, number[0]) &&
+                       parseNumber(fields[2], 0, INT_MAX, number[1]) &&
+                       parseNumber(fields[3], 0, INT_MAX, number[2]) &&
+                       parseNumber(fields[4], 0, INT_MAX, number[3])) {
+                NotePreview& preview = current->preview;
+                preview.modified = static_cast<std::time_t>(number[0]);
+                preview.lines = static_cast<int>(number[1]);
+                preview.openTasks = static_cast<int>(number[2]);
+                preview.doneTasks = static_cast<int>(number[3]);
+                preview.text = fields.size() > 5 ? fields[5] : "";
+                preview.valid = true;
+            } else {
+                // Nothing loaded so far is trusted: the rescan below starts over
+                std::cerr << "Listing cache is corrupt, rescanning" << std::endl;
+                files.clear();
+                stamp = -1;
+                break;
+            }
+        }
+        file.close();
+    }
+
+    // Notes edited in place while the app was closed keep their old size and
+    // mtime until touched again; creates, deletes and our own saves (renames)
+    // all bump the directory stamp.
+    if (stamp != currentStamp()) {
+        rescan();
+    } else {
+        directoryStamp = stamp;
+        changeCount++;
+    }
+    loaded = true;
+}
+
+void ListingCache::save() {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    // Stamp first: a change racing the write makes the file look stale, never fresh
+    int64_t stamp = currentStamp();
+    poll();
+    if (!dirty && stamp == directoryStamp) return;
+
+    std::ostringstream file;
+    file << "D\t" << stamp << "\n";
+    for (const auto& [name, entry] : files) {
+        file << "F\t" << entry.size << "\t" << static_cast<long long>(entry.modified) << "\t" << name << "\n";
+        const NotePreview& preview = entry.preview;
+        if (preview.valid) {
+            file << "P\t" << static_cast<long long>(preview.modified) << "\t" << preview.lines << "\t"
+                 << preview.openTasks << "\t" << preview.doneTasks << "\t" << preview.text << "\n";
+        }
+    }
+    if (FileSystem::writeFileAtomic(cachePath, file.str())) {
+        dirty = false;
+        directoryStamp = stamp;
+    }
+}
+
+void ListingCache::poll() {
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+        if (watchFd >= 0) {
+            if (drainWatch()) return;
+            // Overflowed or the directory was replaced: start over
+            ::close(watchFd);
+            watchFd = -1;
+            startWatch();
+        } else if (currentStamp() == directoryStamp) {
+            return;
+        }
+    }
+    rescan();
+}
+
+void ListingCache::pollAsync(IOWorker& worker) {
+    auto now = std::chrono::steady_clock::now();
+    if (now - lastPoll < POLL_INTERVAL || pollQueued.exchange(true)) return;
+    lastPoll = now;
+    worker.submit([this]() {
+        poll();
+        pollQueued = false;
+    });
+}
+
+size_t ListingCache::memoryUsage() {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    size_t bytes = 0;
+    for (const auto& [name, entry] : files) {
+        // Map node plus the key and the strings in the entry
+        bytes += sizeof(FileEntry) + 4 * sizeof(void*) + name.capacity() + entry.name.capacity() +
+                 entry.displayName.capacity() + entry.preview.text.capacity();
+    }
+    return bytes;
+}
+
+std::vector<FileEntry> ListingCache::entries() {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::vector<FileEntry> list;
+    list.reserve(files.size());
+    for (const auto& [name, entry] : files) list.push_back(entry);
+    return list;
+}
+
+uint64_t ListingCache::version() {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    return changeCount;
+}
+
+void ListingCache::startWatch() {
+#ifdef __linux__
+    if (watchFd >= 0) return;
+    watchFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (watchFd < 0) return;
+    uint32_t mask = IN_CREATE | IN_DELETE | IN_CLOSE_WRITE | IN_ATTRIB |
+                    IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF;
+    if (inotify_add_watch(watchFd, FileSystem::publicDirectory().c_str(), mask) < 0) {
+        std::cerr << "inotify unavailable, falling back to directory polling" << std::endl;
+        ::close(watchFd);
+        watchFd = -1;
+    }
+#endif
+}
+
+bool ListingCache::drainWatch() {
+#ifdef __linux__
+    alignas(struct inotify_event) char buffer[4096];
+    bool intact = true;
+    while (true) {
+        ssize_t len = ::read(watchFd, buffer, sizeof(buffer));
+        if (len <= 0) break; // EAGAIN: queue is empty
+
+        for (char* p = buffer; p < buffer + len;) {
+            auto* event = reinterpret_cast<struct inotify_event*>(p);
+            p += sizeof(struct inotify_event) + event->len;
+
+            if (event->mask & (IN_Q_OVERFLOW | IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED)) {
+                intact = false;
+                continue;
+            }
+            if (event->len == 0 || event->name[0] == '.') continue; // Temp files, hidden metadata
+            updateEntry(event->name);
+        }
+    }
+    return intact;
+#else
+    return false;
+#endif
+}
+
+void ListingCache::rescan() {
+    // The walk happens outside the lock, so the browser isn't held up by it
+    int64_t stamp = currentStamp();
+    std::vector<FileEntry> listing = FileSystem::listFiles(false);
+
+    // Previews survive a rescan; stale ones are caught by their mtime
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::map<std::string, FileEntry> previous;
+    previous.swap(files);
+    directoryStamp = stamp;
+    for (const auto& entry : listing) {
+        FileEntry& file = files[entry.name] = entry;
+        auto old = previous.find(entry.name);
+        if (old != previous.end()) file.preview = old->second.preview;
+    }
+    dirty = true;
+    changeCount++;
+}
+
+void ListingCache::updateEntry(const std::string& name) {
+    std::string path = FileSystem::publicDirectory() + name;
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0 || !S_ISREG(info.st_mode)) {
+        if (files.erase(name) == 0) return;
+    } else {
+        FileEntry& entry = files[name];
+        entry.name = name;
+        entry.displayName = name;
+        entry.size = info.st_size;
+        entry.modified = info.st_mtime;
+    }
+    dirty = true;
+    changeCount++;
+}
+
+int64_t ListingCache::currentStamp() const {
+    std::error_code ec;
+    auto time = std::filesystem::last_write_time(FileSystem::publicDirectory(), ec);
+    if (ec) return 0;
+    return static_cast<int64_t>(time.time_since_epoch().count());
+}
+
+void ListingCache::updatePreview(const std::string& name, const std::vector<Line>& lines,
+                                 const std::string& content, std::time_t modified) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    auto it = files.find(name);
+    if (it == files.end()) {
+        // Saved before the watch reported it
+        updateEntry(name);
+        it = files.find(name);
+        if (it == files.end()) return;
+    }
+    it->second.preview = makePreview(lines, content, modified);
+    dirty = true;
+    changeCount++;
+}
+
+void ListingCache::refreshPreviewsAsync(IOWorker& worker) {
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+        bool stale = std::any_of(files.begin(), files.end(), [](const auto& item) {
+            const FileEntry& entry = item.second;
+            return !entry.preview.valid || entry.preview.modified != entry.modified;
+        });
+        if (!stale) return;
+    }
+    if (previewRefreshQueued.exchange(true)) return;
+    worker.submit([this]() {
+        refreshPreviews();
+        previewRefreshQueued = false;
+    });
+}
+
+void ListingCache::refreshPreviews() {
+    std::vector<std::pair<std::string, std::time_t>> stale;
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+        poll();
+        for (const auto& [name, entry] : files) {
+            if (!entry.preview.valid || entry.preview.modified != entry.modified) {
+                stale.push_back({name, entry.modified});
+            }
+        }
+    }
+
+    // Read without holding the lock so the browser keeps polling freely. A note
+    // that changes mid-read is tagged with the older mtime and redone next time.
+    const size_t kBatch = 64;
+    std::vector<std::pair<std::string, NotePreview>> done;
+    for (size_t i = 0; i < stale.size() && !previewsCancelled; ++i) {
+        std::string content = FileSystem::readFile(stale[i].first, false);
+        done.push_back({stale[i].first, makePreview(NoteFormat::parse(content), content, stale[i].second)});
+
+        if (done.size() == kBatch || i + 1 == stale.size()) {
+            // One version bump per batch, not per note: each bump re-sorts the browser
+            std::lock_guard<std::recursive_mutex> lock(mutex);
+            for (auto& [name, preview] : done) {
+                auto it = files.find(name);
+                if (it != files.end()) it->second.preview = std::move(preview);
+            }
+            done.clear();
+            dirty = true;
+            changeCount++;
+        }
+    }
+}
+
+NotePreview ListingCache::makePreview(const std::vector<Line>& lines, const std::string& content, std::time_t modified) {
+    NotePreview preview;
+    preview.text = VaultManifest::makePreview(content);
+    preview.lines = 0;
+    for (const Line& line : lines) {
+        if (line.content.empty()) continue;
+        preview.lines++;
+        if (!NoteFormat::isTaskBullet(line.bulletType)) continue;
+        if (line.completed) preview.doneTasks++;
+        else preview.openTasks++;
+    }
+    preview.modified = modified;
+    preview.valid = true;
+    return preview;
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include "FileSystem.hpp"
+#include "NoteFormat.hpp"
+#include "IOWorker.hpp"
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+
+// Metadata for the public notes (name, size, mtime), kept in memory and
+// persisted to Notes/listing.idx so entering the browser never walks the
+// directory. On Linux an inotify watch applies changes per file; elsewhere
+// the directory mtime is compared on each poll and a change rescans it.
+// Polls run on the IOWorker, at most once a second.
+// Each entry also carries a NotePreview, refreshed on save and in the
+// background, so the browser never reads a note to describe it.
+// Vault entries are not cached here: they come from the in-memory manifest.
+class ListingCache {
+public:
+    ~ListingCache();
+
+    // Start watching, then load the persisted listing. It is only trusted if
+    // the directory hasn't changed since it was written.
+    void load();
+    void save();
+    // load() runs on the IOWorker at startup; until it is done, don't touch the
+    // cache from the main thread (it would wait on the lock)
+    bool isLoaded() const { return loaded.load(); }
+
+    // Apply pending directory changes. Cheap when nothing changed. Worker thread.
+    void poll();
+    // Main thread, every frame: queues a poll if the last one was a while ago
+    void pollAsync(IOWorker& worker);
+    std::vector<FileEntry> entries();
+    // Bumped on every change, so views can skip re-sorting an unchanged list.
+    uint64_t version();
+    // Estimated bytes held by the entries and their previews
+    size_t memoryUsage();
+
+    // Called with the saved content (IOWorker thread)
+    void updatePreview(const std::string& name, const std::vector<Line>& lines,
+                       const std::string& content, std::time_t modified);
+    // Queue a worker job for notes whose preview is missing or older than the file
+    void refreshPreviewsAsync(IOWorker& worker);
+    // Abandon a running refresh so shutdown doesn't wait on it
+    void cancelPreviews() { previewsCancelled = true; }
+
+private:
+    std::map<std::string, FileEntry> files;
+    int64_t directoryStamp = 0;
+    uint64_t changeCount = 0;
+    bool dirty = false;
+    int watchFd = -1;
+    std::recursive_mutex mutex;
+    std::atomic<bool> loaded{false};
+    std::atomic<bool> previewRefreshQueued{false};
+    std::atomic<bool> previewsCancelled{false};
+    std::atomic<bool> pollQueued{false};
+    std::chrono::steady_clock::time_point lastPoll; // Main thread only
+
+    static constexpr std::chrono::seconds POLL_INTERVAL{1};
+
+    const std::string cachePath = "Notes/listing.idx";
+
+    void startWatch();
+    bool drainWatch(); // False if the watch lost track and a rescan is needed
+    void rescan();
+    void updateEntry(const std::string& name);
+    int64_t currentStamp() const;
+    void refreshPreviews();
+    static NotePreview makePreview(const std::vector<Line>& lines, const std::string& content, std::time_t modified);
+};
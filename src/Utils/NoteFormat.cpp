@@ -0,0 +1,45 @@
+#include "NoteFormat.hpp"
+#include <sstream>
+
+size_t NoteFormat::footprint(const std::vector<Line>& lines) {
+    size_t bytes = lines.capacity() * sizeof(Line);
+    for (const Line& line : lines) bytes += line.content.capacity();
+    return bytes;
+}
+
+std::vector<Line> NoteFormat::parse(const std::string& content) {
+    std::vector<Line> lines;
+    std::istringstream stream(content);
+    std::string raw;
+
+    while (std::getline(stream, raw)) {
+        if (!raw.empty() && raw.back() == '\r') raw.pop_back();
+
+        Line line;
+        if (raw.size() >= 5 && raw[1] == ' ' && raw[2] == '[' && raw[4] == ']' &&
+            (raw[3] == ' ' || raw[3] == 'x')) {
+            line.bulletType = raw[0];
+            line.completed = (raw[3] == 'x');
+            line.content = raw.size() > 6 ? raw.substr(6) : "";
+        } else {
+            line.bulletType = '-';
+            line.content = raw;
+        }
+        if (line.completed) line.opacity = 0.5f;
+        lines.push_back(line);
+    }
+
+    if (lines.empty()) lines.push_back(Line{""});
+    return lines;
+}
+
+std::string NoteFormat::serialize(const std::vector<Line>& lines) {
+    std::string out;
+    for (const auto& line : lines) {
+        out += line.bulletType;
+        out += line.completed ? " [x] " : " [ ] ";
+        out += line.content;
+        out += '\n';
+    }
+    return out;
+}
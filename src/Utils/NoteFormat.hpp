@@ -0,0 +1,34 @@
+#pragma once
+#include <string>
+#include <vector>
+
+struct Line {
+    std::string content;
+    char bulletType = '*'; // •, O, —, !, ?
+    bool completed = false;
+    float popScale = 1.0f; // For "Pop" animation
+    float opacity = 1.0f;
+
+    bool operator==(const Line& other) const {
+        return content == other.content && 
+               bulletType == other.bulletType && 
+               completed == other.completed;
+    }
+};
+
+// Plain-text note format, one line per bullet:
+//   "* [ ] Buy milk"   open task
+//   "* [x] Buy milk"   completed task
+// Lines that don't follow the pattern (e.g. edited on a PC) load as '-' notes.
+class NoteFormat {
+public:
+    static std::vector<Line> parse(const std::string& content);
+    static std::string serialize(const std::vector<Line>& lines);
+    // Estimated heap bytes held by a document, from its capacities
+    static size_t footprint(const std::vector<Line>& lines);
+
+    // Task bullets tracked by the task index: • Task, ! Priority, ? Research
+    static bool isTaskBullet(char bulletType) {
+        return bulletType == '*' || bulletType == '!' || bulletType == '?';
+    }
+};
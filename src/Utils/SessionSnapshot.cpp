@@ -0,0 +1,210 @@
+#include "SessionSnapshot.hpp"
+#include "Compression.hpp"
+#include "FileSystem.hpp"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+namespace {
+
+const char MAGIC[4] = {'N', 'P', 'S', '1'};
+const size_t RECORD_OVERHEAD = 1 + 1 + 4 + 4;
+const size_t COMPRESS_ABOVE = 1024;        // Small sections aren't worth a frame
+const size_t COMPACT_ABOVE = 256 * 1024;   // Journal size before compaction is considered
+const uint8_t FLAG_COMPRESSED = 1;
+
+uint32_t readU32(const std::string& data, size_t pos) {
+    uint32_t v = 0;
+    for (int i = 0; i < 4; ++i) v |= static_cast<uint32_t>(static_cast<uint8_t>(data[pos + i])) << (8 * i);
+    return v;
+}
+
+} // namespace
+
+void SnapshotWriter::f32(float v) {
+    uint32_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    u32(bits);
+}
+
+uint8_t SnapshotReader::u8() {
+    if (!good || pos + 1 > data.size()) { good = false; return 0; }
+    return static_cast<uint8_t>(data[pos++]);
+}
+
+uint32_t SnapshotReader::u32() {
+    if (!good || pos + 4 > data.size()) { good = false; return 0; }
+    uint32_t v = readU32(data, pos);
+    pos += 4;
+    return v;
+}
+
+int64_t SnapshotReader::i64() {
+    uint64_t low = u32();
+    uint64_t high = u32();
+    return static_cast<int64_t>(low | (high << 32));
+}
+
+float SnapshotReader::f32() {
+    uint32_t bits = u32();
+    float v;
+    std::memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+std::string SnapshotReader::str() {
+    uint32_t len = u32();
+    if (!good || len > data.size() - pos) { good = false; return std::string(); }
+    std::string v = data.substr(pos, len);
+    pos += len;
+    return v;
+}
+
+uint32_t SnapshotReader::count(size_t minElementSize) {
+    uint32_t n = u32();
+    if (!good || (minElementSize > 0 && n > (data.size() - pos) / minElementSize)) { good = false; return 0; }
+    return n;
+}
+
+void SessionSnapshot::load() {
+    sections.clear();
+    deferred.clear();
+    records.clear();
+    pending.clear();
+    journalBytes = 0;
+
+    std::ifstream file(snapshotPath, std::ios::binary);
+    if (!file.is_open()) return;
+    std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (data.size() < sizeof(MAGIC) || std::memcmp(data.data(), MAGIC, sizeof(MAGIC)) != 0) return;
+
+    size_t pos = sizeof(MAGIC);
+    while (pos + RECORD_OVERHEAD <= data.size()) {
+        SessionSection section = static_cast<SessionSection>(static_cast<uint8_t>(data[pos]));
+        uint8_t flags = static_cast<uint8_t>(data[pos + 1]);
+        uint32_t len = readU32(data, pos + 2);
+        if (len > data.size() - pos - RECORD_OVERHEAD) break; // Torn tail
+        std::string payload = data.substr(pos + 6, len);
+        if (checksum(payload) != readU32(data, pos + 6 + len)) break;
+        std::string record = data.substr(pos, RECORD_OVERHEAD + len);
+        pos += RECORD_OVERHEAD + len;
+
+        if (flags & FLAG_COMPRESSED) {
+            std::string raw;
+            if (!Compression::decompress(payload, raw)) break;
+            payload.swap(raw);
+        }
+        if (payload.empty()) {
+            sections.erase(section);
+            records.erase(section);
+        } else {
+            sections[section] = std::move(payload);
+            records[section] = std::move(record);
+        }
+    }
+
+    if (pos == data.size()) {
+        journalBytes = pos;
+    } else {
+        // Appending after garbage would hide the new records; rewrite on the next flush
+        std::cerr << "Session snapshot: dropped a damaged tail" << std::endl;
+    }
+}
+
+const std::string* SessionSnapshot::get(SessionSection section) const {
+    auto it = sections.find(section);
+    return it == sections.end() ? nullptr : &it->second;
+}
+
+void SessionSnapshot::put(SessionSection section, std::string payload) {
+    auto it = sections.find(section);
+    bool known = deferred.erase(section) == 0;
+    if (known && (it == sections.end() ? payload.empty() : it->second == payload)) return;
+
+    if (payload.empty()) {
+        sections.erase(section);
+        pending[section] = []() { return std::string(); };
+    } else {
+        std::string& live = sections[section] = std::move(payload);
+        pending[section] = [live]() { return live; };
+    }
+}
+
+void SessionSnapshot::putDeferred(SessionSection section, std::function<std::string()> encode) {
+    sections.erase(section);
+    deferred.insert(section);
+    pending[section] = std::move(encode);
+}
+
+void SessionSnapshot::clearAll() {
+    for (const auto& [section, payload] : sections) pending[section] = []() { return std::string(); };
+    for (SessionSection section : deferred) pending[section] = []() { return std::string(); };
+    sections.clear();
+    deferred.clear();
+}
+
+void SessionSnapshot::flush(IOWorker& worker) {
+    if (pending.empty()) return;
+    std::map<SessionSection, Encoder> changed;
+    changed.swap(pending);
+
+    worker.submit([this, changed = std::move(changed)]() {
+        std::string appended;
+        for (const auto& [section, encode] : changed) {
+            std::string payload = encode();
+            std::string record = encodeRecord(section, payload);
+            appended += record;
+            if (payload.empty()) records.erase(section);
+            else records[section] = std::move(record);
+        }
+
+        size_t liveBytes = sizeof(MAGIC);
+        for (const auto& [section, record] : records) liveBytes += record.size();
+        bool rewrite = journalBytes == 0 ||
+                       (journalBytes + appended.size() > COMPACT_ABOVE && journalBytes + appended.size() > 4 * liveBytes);
+
+        if (rewrite) {
+            // Only the live records: superseded ones (and any damaged tail) go away
+            std::string live(MAGIC, sizeof(MAGIC));
+            for (const auto& [section, record] : records) live += record;
+            journalBytes = FileSystem::writeFileAtomic(snapshotPath, live) ? live.size() : 0;
+            return;
+        }
+
+        // Not synced: a kill leaves it in the page cache, and a torn tail is detected on load
+        std::ofstream file(snapshotPath, std::ios::binary | std::ios::app);
+        if (file.is_open()) file.write(appended.data(), appended.size());
+        // A failed append leaves the file unknown: rewrite it next time
+        journalBytes = file.is_open() && file ? journalBytes + appended.size() : 0;
+    });
+}
+
+std::string SessionSnapshot::encodeRecord(SessionSection section, const std::string& payload) {
+    uint8_t flags = 0;
+    std::string stored = payload;
+    if (payload.size() > COMPRESS_ABOVE) {
+        std::string frame = Compression::compress(payload);
+        if (frame.size() < payload.size()) {
+            stored.swap(frame);
+            flags |= FLAG_COMPRESSED;
+        }
+    }
+
+    SnapshotWriter record;
+    record.u8(static_cast<uint8_t>(section));
+    record.u8(flags);
+    record.u32(static_cast<uint32_t>(stored.size()));
+    record.data += stored;
+    record.u32(checksum(stored));
+    return record.data;
+}
+
+uint32_t SessionSnapshot::checksum(const std::string& data) {
+    uint32_t hash = 2166136261u;
+    for (unsigned char c : data) {
+        hash ^= c;
+        hash *= 16777619u;
+    }
+    return hash;
+}
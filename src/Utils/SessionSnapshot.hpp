@@ -0,0 +1,102 @@
+#pragma once
+#include "IOWorker.hpp"
+#include <string>
+#include <map>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <set>
+
+// Little-endian binary encoding for snapshot sections
+class SnapshotWriter {
+public:
+    void u8(uint8_t v) { data.push_back(static_cast<char>(v)); }
+    void u32(uint32_t v) { for (int i = 0; i < 4; ++i) u8(static_cast<uint8_t>(v >> (8 * i))); }
+    void i32(int32_t v) { u32(static_cast<uint32_t>(v)); }
+    void i64(int64_t v) { u32(static_cast<uint32_t>(v)); u32(static_cast<uint32_t>(static_cast<uint64_t>(v) >> 32)); }
+    void f32(float v);
+    void str(const std::string& v) { u32(static_cast<uint32_t>(v.size())); data += v; }
+
+    std::string data;
+};
+
+// Reads what SnapshotWriter wrote. Running off the end clears ok() and yields zeros.
+class SnapshotReader {
+public:
+    explicit SnapshotReader(const std::string& data) : data(data) {}
+
+    uint8_t u8();
+    uint32_t u32();
+    int32_t i32() { return static_cast<int32_t>(u32()); }
+    int64_t i64();
+    float f32();
+    std::string str();
+    // Element counts are checked against what's left, so a corrupt count can't allocate gigabytes
+    uint32_t count(size_t minElementSize);
+
+    bool ok() const { return good; }
+    bool atEnd() const { return pos == data.size(); }
+
+private:
+    const std::string& data;
+    size_t pos = 0;
+    bool good = true;
+};
+
+enum class SessionSection : uint8_t {
+    NAVIGATION = 1,      // Name of the state on top
+    EDITOR_VIEW = 2,     // Open note, cursor, scroll, layout
+    EDITOR_DOCUMENT = 3, // Lines and saved content
+    CANVAS = 4,          // Shapes, arrows and undo history
+    EDITOR_HISTORY = 5   // Undo history of EDITOR_DOCUMENT, written at quit
+};
+
+// What the app was doing, kept in Notes/session.snap so a restart (handhelds
+// get killed on suspend all the time) comes back to it. The file is a journal:
+// each flush appends only the sections that changed since the last one, the
+// latest record of each section wins on load, and a torn tail from a kill
+// mid-write is dropped by its checksum. Once the journal is mostly superseded
+// records it is rewritten with just the live ones.
+//
+// Record: section u8 | flags u8 | length u32le | payload | FNV-1a u32le of payload.
+// Large payloads are stored as an NPZ1 frame (flag 1). An empty payload
+// clears the section. Vault notes never go in here. Records are encoded,
+// compressed and written on the IOWorker.
+class SessionSnapshot {
+public:
+    // Main thread, before the IOWorker gets its first flush
+    void load();
+
+    // Latest payload for a section, nullptr if there is none
+    const std::string* get(SessionSection section) const;
+
+    // Main thread. Recorded only if different from what's already there;
+    // nothing touches the card until flush().
+    void put(SessionSection section, std::string payload);
+    // Main thread. For big sections: encode runs on the worker at the next
+    // flush(), so it must only use what it captured. The caller decides
+    // whether anything changed.
+    void putDeferred(SessionSection section, std::function<std::string()> encode);
+    void clear(SessionSection section) { put(section, std::string()); }
+    void clearAll();
+
+    // Appends the changed sections from the worker
+    void flush(IOWorker& worker);
+
+private:
+    using Encoder = std::function<std::string()>;
+
+    // Main thread
+    std::map<SessionSection, std::string> sections; // Live payloads (what load() would return)
+    std::set<SessionSection> deferred;              // Sections put by putDeferred, not in sections
+    std::map<SessionSection, Encoder> pending;      // Payloads changed since the last flush
+
+    // Worker thread (and load(), before the first flush)
+    std::map<SessionSection, std::string> records;  // Live payloads encoded, for compaction
+    size_t journalBytes = 0; // 0 means the file must be rewritten
+
+    const std::string snapshotPath = "Notes/session.snap";
+
+    static std::string encodeRecord(SessionSection section, const std::string& payload);
+    static uint32_t checksum(const std::string& data);
+};
@@ -0,0 +1,52 @@
+#include "StartupProfiler.hpp"
+#include <iostream>
+#include <sstream>
+
+StartupProfiler::StartupProfiler() : start(Clock::now()), lastMark(start) {}
+
+void StartupProfiler::mark(const std::string& phase) {
+    Clock::time_point now = Clock::now();
+    phases.push_back({phase, std::chrono::duration<double, std::milli>(now - lastMark).count()});
+    lastMark = now;
+}
+
+void StartupProfiler::firstPresent() {
+    if (hasPresented()) return;
+    mark("first frame");
+    firstPresentMs = elapsedMs();
+}
+
+void StartupProfiler::addDeferred(const std::string& phase, double ms) {
+    std::lock_guard<std::mutex> lock(mutex);
+    deferred.push_back({phase, ms});
+}
+
+double StartupProfiler::elapsedMs() const {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void StartupProfiler::report() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& phase : phases) {
+        std::cout << "Startup " << phase.name << ": " << phase.ms << "ms" << std::endl;
+    }
+    std::cout << "Startup first present: " << firstPresentMs << "ms" << std::endl;
+    for (const auto& phase : deferred) {
+        std::cout << "Startup (deferred) " << phase.name << ": " << phase.ms << "ms" << std::endl;
+    }
+}
+
+std::string StartupProfiler::toJson() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::ostringstream json;
+    json << "{\"bench\":\"startup\",\"first_present_ms\":" << firstPresentMs << ",\"phases\":{";
+    for (size_t i = 0; i < phases.size(); ++i) {
+        json << (i ? "," : "") << "\"" << phases[i].name << "\":" << phases[i].ms;
+    }
+    json << "},\"deferred\":{";
+    for (size_t i = 0; i < deferred.size(); ++i) {
+        json << (i ? "," : "") << "\"" << deferred[i].name << "\":" << deferred[i].ms;
+    }
+    json << "}}";
+    return json.str();
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Wall-clock timing of startup, phase by phase, from App construction to the
+// first presented frame. Work deferred past that frame (background loads,
+// pre-rendering) is timed too, so it shows up in the report without counting
+// towards time-to-first-present. Uses std::chrono: it runs before SDL_Init.
+class StartupProfiler {
+public:
+    StartupProfiler();
+
+    // Main thread: ends the phase that ran since the previous mark
+    void mark(const std::string& phase);
+    void firstPresent();
+    bool hasPresented() const { return firstPresentMs >= 0.0; }
+
+    // Any thread: deferred work that timed itself
+    void addDeferred(const std::string& phase, double ms);
+
+    double elapsedMs() const;
+    void report() const;      // Human readable, to stdout
+    std::string toJson() const; // One line, for --bench-startup
+
+private:
+    using Clock = std::chrono::steady_clock;
+    struct Phase {
+        std::string name;
+        double ms = 0.0;
+    };
+
+    Clock::time_point start;
+    Clock::time_point lastMark;
+    double firstPresentMs = -1.0;
+    std::vector<Phase> phases;
+    std::vector<Phase> deferred;
+    mutable std::mutex mutex; // deferred is written from the IOWorker
+};
@@ -0,0 +1,159 @@
+#include "TaskIndex.hpp"
+#include "FileSystem.hpp"
+#include "ListingCache.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <iostream>
+#include <set>
+
+// Index file layout (tab separated, one record per line):
+//   N <mtime> <note>
+//   T <line> <bullet> <completed> <text>      (belongs to the preceding N)
+
+namespace {
+
+// The whole field must be a number; a torn or hand-edited index is rebuilt, not trusted
+bool parseNumber(const std::string& field, long long min, long long max, long long& value) {
+    if (field.empty()) return false;
+    char* end = nullptr;
+    errno = 0;
+    value = std::strtoll(field.c_str(), &end, 10);
+    return errno == 0 && *end == '\0' && value >= min && value <= max;
+}
+
+} // namespace
+
+void TaskIndex::load(ListingCache& listing) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    notes.clear();
+    std::ifstream file(indexPath);
+    if (file.is_open()) {
+        std::string record;
+        NoteTasks* current = nullptr;
+        std::string currentName;
+        while (std::getline(file, record)) {
+            if (record.empty()) continue;
+            std::vector<std::string> fields;
+            std::stringstream ss(record);
+            std::string field;
+            while (std::getline(ss, field, '\t')) fields.push_back(field);
+
+            long long number = 0;
+            if (fields.size() >= 3 && fields[0] == "N" && parseNumber(fields[1], LLONG_MIN, LLONG_MAX, number)) {
+                currentName = fields[2];
+                current = &notes[currentName];
+                current->modified = static_cast<std::time_t>(number);
+            } else if (fields.size() >= 4 && fields[0] == "T" && current && parseNumber(fields[1], 0, INT_MAX, number)) {
+                TaskEntry task;
+                task.note = currentName;
+                task.line = static_cast<int>(number);
+                task.bulletType = fields[2].empty() ? '*' : fields[2][0];
+                task.completed = (fields[3] == "1");
+                task.text = fields.size() > 4 ? fields[4] : "";
+                task.modified = current->modified;
+                current->tasks.push_back(task);
+            } else {
+                // Every note is re-parsed below and the index written out fresh
+                std::cerr << "Task index is corrupt, rebuilding it" << std::endl;
+                notes.clear();
+                dirty = true;
+                break;
+            }
+        }
+        file.close();
+    }
+
+    refresh(listing);
+}
+
+void TaskIndex::refresh(ListingCache& listing) {
+    std::set<std::string> present;
+    for (const auto& file : listing.entries()) {
+        present.insert(file.name);
+        auto it = notes.find(file.name);
+        if (it != notes.end() && it->second.modified == file.modified) continue;
+
+        updateNote(file.name, NoteFormat::parse(FileSystem::readFile(file.name, false)), file.modified);
+    }
+
+    for (auto it = notes.begin(); it != notes.end();) {
+        if (present.count(it->first) == 0) {
+            it = notes.erase(it);
+            dirty = true;
+        } else {
+            ++it;
+        }
+    }
+
+    if (dirty) save();
+}
+
+void TaskIndex::save() {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::ostringstream file;
+    for (const auto& [name, entry] : notes) {
+        file << "N\t" << static_cast<long long>(entry.modified) << "\t" << name << "\n";
+        for (const auto& task : entry.tasks) {
+            file << "T\t" << task.line << "\t" << task.bulletType << "\t"
+                 << (task.completed ? 1 : 0) << "\t" << task.text << "\n";
+        }
+    }
+    if (FileSystem::writeFileAtomic(indexPath, file.str())) dirty = false;
+}
+
+void TaskIndex::updateNote(const std::string& note, const std::vector<Line>& lines, std::time_t modified) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    NoteTasks& entry = notes[note];
+    entry.modified = modified;
+    entry.tasks.clear();
+
+    for (size_t i = 0; i < lines.size(); ++i) {
+        const Line& l = lines[i];
+        if (!NoteFormat::isTaskBullet(l.bulletType) || l.content.empty()) continue;
+
+        TaskEntry task;
+        task.note = note;
+        task.line = static_cast<int>(i);
+        task.bulletType = l.bulletType;
+        task.completed = l.completed;
+        task.text = l.content;
+        std::replace(task.text.begin(), task.text.end(), '\t', ' ');
+        task.modified = modified;
+        entry.tasks.push_back(task);
+    }
+    dirty = true;
+}
+
+void TaskIndex::removeNote(const std::string& note) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    if (notes.erase(note) > 0) dirty = true;
+}
+
+size_t TaskIndex::memoryUsage() const {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    size_t bytes = 0;
+    for (const auto& [name, entry] : notes) {
+        bytes += sizeof(NoteTasks) + 4 * sizeof(void*) + name.capacity() + entry.tasks.capacity() * sizeof(TaskEntry);
+        for (const auto& task : entry.tasks) bytes += task.note.capacity() + task.text.capacity();
+    }
+    return bytes;
+}
+
+std::vector<TaskEntry> TaskIndex::openTasks() const {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::vector<TaskEntry> open;
+    for (const auto& [name, entry] : notes) {
+        for (const auto& task : entry.tasks) {
+            if (!task.completed) open.push_back(task);
+        }
+    }
+
+    std::stable_sort(open.begin(), open.end(), [](const TaskEntry& a, const TaskEntry& b) {
+        if (a.modified != b.modified) return a.modified > b.modified;
+        if (a.note != b.note) return a.note < b.note;
+        return a.line < b.line;
+    });
+    return open;
+}
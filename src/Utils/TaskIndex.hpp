@@ -0,0 +1,52 @@
+#pragma once
+#include "NoteFormat.hpp"
+#include <string>
+#include <vector>
+#include <map>
+#include <ctime>
+#include <mutex>
+
+class ListingCache;
+
+struct TaskEntry {
+    std::string note;
+    int line = 0;
+    char bulletType = '*';
+    bool completed = false;
+    std::string text;
+    std::time_t modified = 0;
+};
+
+// Cross-note index of task bullets ('*', '!', '?') in public notes.
+// Persisted to disk and updated per note on save, so listing open tasks never
+// has to open every journal. Vault notes are deliberately not indexed: the
+// index is plaintext. Thread-safe: saves update it from the IOWorker.
+class TaskIndex {
+public:
+    // Load the persisted index, then re-parse only notes whose mtime changed.
+    // The listing must be loaded already: it says which notes exist.
+    void load(ListingCache& listing);
+    void save();
+
+    void updateNote(const std::string& note, const std::vector<Line>& lines, std::time_t modified);
+    void removeNote(const std::string& note);
+
+    // Open tasks across all notes, most recently modified note first.
+    std::vector<TaskEntry> openTasks() const;
+    // Estimated bytes held in memory
+    size_t memoryUsage() const;
+
+private:
+    struct NoteTasks {
+        std::time_t modified = 0;
+        std::vector<TaskEntry> tasks;
+    };
+
+    std::map<std::string, NoteTasks> notes;
+    bool dirty = false;
+    mutable std::recursive_mutex mutex;
+
+    const std::string indexPath = "Notes/tasks.idx";
+
+    void refresh(ListingCache& listing);
+};
@@ -0,0 +1,144 @@
+#include "Telemetry.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+
+std::atomic<int> Telemetry::liveTextures{0};
+std::atomic<unsigned long> Telemetry::createdTextures{0};
+
+namespace {
+
+long readLong(const char* path) {
+    std::ifstream file(path);
+    long value = -1;
+    if (file.is_open()) file >> value;
+    return file ? value : -1;
+}
+
+} // namespace
+
+Telemetry::~Telemetry() {
+    stop();
+}
+
+void Telemetry::start() {
+    if (thread.joinable()) return;
+    stopping = false;
+    thread = std::thread(&Telemetry::loop, this);
+}
+
+void Telemetry::stop() {
+    if (!thread.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    thread.join();
+}
+
+void Telemetry::loop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopping) {
+        lock.unlock();
+        SystemSample sample = readSystem();
+        lock.lock();
+
+        if (sampleRing.size() < SAMPLE_HISTORY) sampleRing.push_back(sample);
+        else sampleRing[sampleHead] = sample;
+        sampleHead = (sampleHead + 1) % SAMPLE_HISTORY;
+
+        wake.wait_for(lock, std::chrono::milliseconds(SAMPLE_INTERVAL_MS), [this]() { return stopping; });
+    }
+}
+
+SystemSample Telemetry::readSystem() {
+    SystemSample sample;
+    sample.ticks = SDL_GetTicks();
+
+    std::ifstream statm("/proc/self/statm");
+    long sizePages = 0, residentPages = 0;
+    if (statm >> sizePages >> residentPages) sample.rssKB = residentPages * (sysconf(_SC_PAGESIZE) / 1024);
+
+    std::ifstream meminfo("/proc/meminfo");
+    std::string key;
+    long value = 0;
+    std::string unit;
+    while (meminfo >> key >> value >> unit) {
+        if (key == "MemTotal:") sample.memTotalKB = value;
+        else if (key == "MemAvailable:") sample.memAvailableKB = value;
+    }
+    if (sample.memTotalKB < 0) {
+        // No procfs (macOS): what sysconf knows
+        sample.memTotalKB = sysconf(_SC_PHYS_PAGES) * (sysconf(_SC_PAGESIZE) / 1024);
+#ifdef _SC_AVPHYS_PAGES
+        sample.memAvailableKB = sysconf(_SC_AVPHYS_PAGES) * (sysconf(_SC_PAGESIZE) / 1024);
+#endif
+    }
+
+    // "some avg10=1.23 avg60=... total=..."
+    std::ifstream pressure("/proc/pressure/memory");
+    std::string kind, avg10;
+    if (pressure >> kind >> avg10 && kind == "some" && avg10.compare(0, 6, "avg10=") == 0) {
+        sample.memoryStallPercent = std::strtof(avg10.c_str() + 6, nullptr);
+    }
+
+    sample.batteryPercent = static_cast<int>(readLong("/sys/class/power_supply/battery/capacity"));
+    long freqKHz = readLong("/sys/devices/system/cpu/cpu0/cpufreq/scaling_cur_freq");
+    if (freqKHz > 0) sample.cpuFreqMHz = static_cast<int>(freqKHz / 1000);
+    return sample;
+}
+
+SystemSample Telemetry::latest() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (sampleRing.empty()) return SystemSample();
+    return sampleRing[(sampleHead + SAMPLE_HISTORY - 1) % SAMPLE_HISTORY % sampleRing.size()];
+}
+
+std::vector<SystemSample> Telemetry::samples() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (sampleRing.size() < SAMPLE_HISTORY) return sampleRing;
+    std::vector<SystemSample> ordered(sampleRing.begin() + sampleHead, sampleRing.end());
+    ordered.insert(ordered.end(), sampleRing.begin(), sampleRing.begin() + sampleHead);
+    return ordered;
+}
+
+void Telemetry::recordFrame(float frameMs, float workMs) {
+    frameRing[frameHead] = frameMs;
+    workRing[frameHead] = workMs;
+    frameHead = (frameHead + 1) % FRAME_HISTORY;
+    frameCount = std::min(frameCount + 1, FRAME_HISTORY);
+}
+
+std::vector<float> Telemetry::frameTimes() const {
+    std::vector<float> ordered;
+    ordered.reserve(frameCount);
+    for (size_t i = FRAME_HISTORY - frameCount; i < FRAME_HISTORY; ++i) {
+        ordered.push_back(frameRing[(frameHead + i) % FRAME_HISTORY]);
+    }
+    return ordered;
+}
+
+FrameStats Telemetry::frameStats() const {
+    return statsOf(frameRing, frameCount);
+}
+
+FrameStats Telemetry::workStats() const {
+    return statsOf(workRing, frameCount);
+}
+
+FrameStats Telemetry::statsOf(const std::vector<float>& ring, size_t count) {
+    FrameStats stats;
+    if (count == 0) return stats;
+    // The ring is only full-length once it has wrapped; before that the filled part is the front
+    std::vector<float> sorted(ring.begin(), ring.begin() + count);
+    std::sort(sorted.begin(), sorted.end());
+    stats.p50 = sorted[count / 2];
+    stats.p99 = sorted[std::min(count - 1, count * 99 / 100)];
+    stats.max = sorted.back();
+    return stats;
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// One reading of the system, taken by the sampler thread. -1 means unknown
+// (e.g. no battery node on the desktop).
+struct SystemSample {
+    Uint32 ticks = 0;
+    long rssKB = -1;          // This process (/proc/self/statm)
+    long memTotalKB = -1;     // /proc/meminfo
+    long memAvailableKB = -1;
+    float memoryStallPercent = -1.0f; // PSI "some avg10" (/proc/pressure/memory), kernels 4.20+
+    int batteryPercent = -1;  // /sys/class/power_supply/battery/capacity
+    int cpuFreqMHz = -1;      // cpu0 scaling_cur_freq
+};
+
+struct FrameStats {
+    float p50 = 0.0f;
+    float p99 = 0.0f;
+    float max = 0.0f;
+};
+
+// What a state's own data costs against its budget (State::memoryUsage)
+struct StateMemory {
+    std::string state;
+    size_t bytes = 0;
+    size_t budget = 0; // 0: none
+};
+
+// Background sampler for the performance HUD and the settings footer. System
+// readings (procfs/sysfs) happen once a second on its own thread; per-frame
+// timings are recorded by the main thread. Both live in ring buffers, so
+// anything that displays them only reads cached values.
+class Telemetry {
+public:
+    static constexpr int SAMPLE_INTERVAL_MS = 1000;
+    static constexpr size_t SAMPLE_HISTORY = 120; // Two minutes
+    static constexpr size_t FRAME_HISTORY = 240;  // About four seconds at 60 fps
+
+    ~Telemetry();
+    void start();
+    void stop();
+
+    // Any thread
+    SystemSample latest() const;
+    std::vector<SystemSample> samples() const; // Oldest first
+
+    // Main thread. frameMs is present to present; workMs excludes the vsync/sleep wait.
+    void recordFrame(float frameMs, float workMs);
+    std::vector<float> frameTimes() const; // Oldest first
+    FrameStats frameStats() const;
+    FrameStats workStats() const;
+
+    // Main thread. Refreshed by App about once a second, current state first.
+    void recordStateMemory(std::vector<StateMemory> states) { stateMemoryList = std::move(states); }
+    const std::vector<StateMemory>& stateMemory() const { return stateMemoryList; }
+
+    // Live SDL textures, counted at the create/destroy sites
+    static void textureCreated() { liveTextures++; createdTextures++; }
+    static void textureDestroyed() { liveTextures--; }
+    static int textureCount() { return liveTextures.load(); }
+    static unsigned long texturesCreated() { return createdTextures.load(); } // Ever; diff per frame for churn
+
+private:
+    std::thread thread;
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+    std::vector<SystemSample> sampleRing;
+    size_t sampleHead = 0;
+
+    std::vector<float> frameRing = std::vector<float>(FRAME_HISTORY, 0.0f);
+    std::vector<float> workRing = std::vector<float>(FRAME_HISTORY, 0.0f);
+    size_t frameHead = 0;
+    size_t frameCount = 0;
+    std::vector<StateMemory> stateMemoryList;
+
+    static std::atomic<int> liveTextures;
+    static std::atomic<unsigned long> createdTextures;
+
+    void loop();
+    static SystemSample readSystem();
+    static FrameStats statsOf(const std::vector<float>& ring, size_t count);
+};
@@ -0,0 +1,259 @@
+#include "TextRasterizer.hpp"
+#include "Telemetry.hpp"
+#include "Trace.hpp"
+#include <algorithm>
+
+TextRasterizer::~TextRasterizer() {
+    close();
+}
+
+bool TextRasterizer::start() {
+    if (thread.joinable()) return false;
+    stopping = false;
+    thread = std::thread(&TextRasterizer::loop, this);
+    return true;
+}
+
+void TextRasterizer::stop() {
+    if (!thread.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        jobs.clear();
+    }
+    wake.notify_one();
+    thread.join();
+
+    for (Result& result : results) SDL_FreeSurface(result.surface);
+    results.clear();
+    // Nobody is working on the pending ones now; the next get() redoes them inline
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (it->second.pending) it = entries.erase(it);
+        else ++it;
+    }
+}
+
+void TextRasterizer::close() {
+    stop();
+    clear();
+}
+
+void TextRasterizer::loop() {
+    TRACE_THREAD("TextRasterizer");
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        if (!wake.wait_for(lock, WORKER_FONT_IDLE, [this]() { return stopping || !jobs.empty(); })) {
+            lock.unlock();
+            closeIdleWorkerFonts(false);
+            lock.lock();
+            continue;
+        }
+        if (stopping) break;
+        Job job = std::move(jobs.front());
+        jobs.pop_front();
+        lock.unlock();
+
+        SDL_Surface* surface = nullptr;
+        {
+            TRACE_SCOPE("TextRasterizer::render");
+            if (TTF_Font* font = workerFont(std::get<0>(job.key))) {
+                surface = TTF_RenderText_Blended(font, std::get<2>(job.key).c_str(), job.color);
+            }
+        }
+        closeIdleWorkerFonts(false);
+
+        lock.lock();
+        results.push_back({std::move(job.key), surface});
+        finished.notify_one();
+    }
+    lock.unlock();
+    closeIdleWorkerFonts(true);
+}
+
+TTF_Font* TextRasterizer::workerFont(Font font) {
+    auto it = workerFonts.find(font);
+    if (it == workerFonts.end()) it = workerFonts.emplace(font, WorkerFont{fonts.open(font), {}}).first;
+    it->second.lastUsed = std::chrono::steady_clock::now();
+    return it->second.font;
+}
+
+void TextRasterizer::closeIdleWorkerFonts(bool all) {
+    auto now = std::chrono::steady_clock::now();
+    for (auto it = workerFonts.begin(); it != workerFonts.end();) {
+        if (!all && now - it->second.lastUsed < WORKER_FONT_IDLE) {
+            ++it;
+            continue;
+        }
+        if (it->second.font) fonts.release(it->second.font);
+        it = workerFonts.erase(it);
+    }
+}
+
+void TextRasterizer::beginFrame(SDL_Renderer* renderer) {
+    frame++;
+    waitBudgetMs = WAIT_BUDGET_MS;
+    fonts.beginFrame();
+    collect(renderer);
+    if (frame % SWEEP_INTERVAL_FRAMES != 0) return;
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (!it->second.pending && frame - it->second.lastUsed > EVICT_AFTER_FRAMES) {
+            destroy(it->second);
+            it = entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void TextRasterizer::collect(SDL_Renderer* renderer) {
+    std::vector<Result> finished;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        finished.swap(results);
+    }
+    for (Result& result : finished) {
+        auto it = entries.find(result.key);
+        // Cleared while it was being drawn; or cleared and queued again, and
+        // an earlier job for the same text already filled it in
+        if (it == entries.end() || !it->second.pending) {
+            SDL_FreeSurface(result.surface);
+            continue;
+        }
+        upload(renderer, it->second, result.surface);
+    }
+}
+
+void TextRasterizer::upload(SDL_Renderer* renderer, Entry& entry, SDL_Surface* surface) {
+    entry.pending = false;
+    if (!surface) return;
+    entry.text.texture = SDL_CreateTextureFromSurface(renderer, surface);
+    if (entry.text.texture) Telemetry::textureCreated();
+    entry.text.w = surface->w;
+    entry.text.h = surface->h;
+    SDL_FreeSurface(surface);
+}
+
+const TextRasterizer::Text* TextRasterizer::get(SDL_Renderer* renderer, Font font, const std::string& text, SDL_Color color) {
+    if (text.empty()) return nullptr;
+    Key key{font, pack(color), text};
+    auto it = entries.find(key);
+    if (it == entries.end()) {
+        it = entries.emplace(std::move(key), Entry()).first;
+        if (const BakedFont::Face* atlas = fonts.atlas(font, text)) {
+            // Copying glyphs out of the atlas is cheap enough to do right here
+            upload(renderer, it->second, atlas->render(text, color));
+        } else if (thread.joinable()) {
+            it->second.pending = true;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                jobs.push_back({it->first, color});
+            }
+            wake.notify_one();
+        } else {
+            upload(renderer, it->second, render(font, text, color));
+        }
+    } else if (it->second.pending) {
+        collect(renderer); // Strings queued earlier this frame are often done by now
+    }
+    it->second.lastUsed = frame;
+    return it->second.text.texture ? &it->second.text : nullptr;
+}
+
+SDL_Surface* TextRasterizer::render(Font font, const std::string& text, SDL_Color color) {
+    if (text.empty()) return nullptr;
+    if (const BakedFont::Face* atlas = fonts.atlas(font, text)) return atlas->render(text, color);
+    TTF_Font* ttf = fonts.ttf(font);
+    return ttf ? TTF_RenderText_Blended(ttf, text.c_str(), color) : nullptr;
+}
+
+void TextRasterizer::measure(Font font, const std::string& text, int* w, int* h) {
+    if (const BakedFont::Face* atlas = fonts.atlas(font, text)) {
+        atlas->measure(text, w, h);
+    } else if (TTF_Font* ttf = fonts.ttf(font)) {
+        TTF_SizeText(ttf, text.c_str(), w, h);
+    } else {
+        *w = 0;
+        *h = fonts.lineHeight(font);
+    }
+}
+
+void TextRasterizer::draw(SDL_Renderer* renderer, Font font, const std::string& text, SDL_Color color,
+                          int x, int y, float scale, bool centered) {
+    if (text.empty()) return;
+    // Scaled text comes from its own size; only what the snapping left over is stretched
+    Font sized = FontManager::scaled(font, scale);
+    float stretch = scale * font.size / sized.size;
+    const Text* cached = get(renderer, sized, text, color);
+    if (!cached) cached = waitFor(renderer, Key{sized, pack(color), text});
+    if (!cached && sized != font) {
+        // Not ready at that size yet: stretch the unscaled one meanwhile
+        cached = get(renderer, font, text, color);
+        stretch = scale;
+    }
+    if (!cached) {
+        // Roughly where the text will be, in a faint version of its colour
+        int h = fonts.lineHeight(font);
+        int w = static_cast<int>(text.size()) * h / 2;
+        SDL_Rect bar = {centered ? x - w / 2 : x, (centered ? y - h / 2 : y) + h / 3, w, h / 3};
+        SDL_BlendMode previousBlend;
+        SDL_GetRenderDrawBlendMode(renderer, &previousBlend);
+        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+        SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, 40);
+        SDL_RenderFillRect(renderer, &bar);
+        SDL_SetRenderDrawBlendMode(renderer, previousBlend);
+        return;
+    }
+
+    int w = static_cast<int>(cached->w * stretch);
+    int h = static_cast<int>(cached->h * stretch);
+    int unscaledW = static_cast<int>(w / scale);
+    int unscaledH = static_cast<int>(h / scale);
+    SDL_Rect dst = centered ? SDL_Rect{x - w / 2, y - h / 2, w, h}
+                            : SDL_Rect{x - (w - unscaledW) / 2, y - (h - unscaledH) / 2, w, h};
+    SDL_RenderCopy(renderer, cached->texture, NULL, &dst);
+}
+
+const TextRasterizer::Text* TextRasterizer::waitFor(SDL_Renderer* renderer, const Key& key) {
+    auto found = entries.find(key);
+    if (found == entries.end() || !found->second.pending) return nullptr; // Failed to render: nothing to wait for
+
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point start = Clock::now();
+    auto deadline = start + std::chrono::duration<double, std::milli>(waitBudgetMs);
+    {
+        TRACE_SCOPE("TextRasterizer::wait");
+        std::unique_lock<std::mutex> lock(mutex);
+        // Jobs run in order, so this one is done when its result shows up
+        finished.wait_until(lock, deadline, [&]() {
+            return std::any_of(results.begin(), results.end(), [&](const Result& result) { return result.key == key; });
+        });
+    }
+    waitBudgetMs = std::max(0.0, waitBudgetMs - std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+    collect(renderer);
+    auto it = entries.find(key);
+    return it != entries.end() && it->second.text.texture ? &it->second.text : nullptr;
+}
+
+void TextRasterizer::clear() {
+    for (auto& [key, entry] : entries) destroy(entry);
+    entries.clear();
+}
+
+size_t TextRasterizer::memoryUsage() const {
+    size_t bytes = 0;
+    for (const auto& [key, entry] : entries) {
+        bytes += sizeof(Entry) + std::get<2>(key).capacity() + static_cast<size_t>(entry.text.w) * entry.text.h * 4;
+    }
+    return bytes;
+}
+
+void TextRasterizer::destroy(Entry& entry) {
+    if (!entry.text.texture) return;
+    SDL_DestroyTexture(entry.text.texture);
+    Telemetry::textureDestroyed();
+    entry.text.texture = nullptr;
+}
+
+Uint32 TextRasterizer::pack(SDL_Color color) {
+    return (Uint32(color.r) << 24) | (Uint32(color.g) << 16) | (Uint32(color.b) << 8) | color.a;
+}
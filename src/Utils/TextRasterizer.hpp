@@ -0,0 +1,106 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+#include "FontManager.hpp"
+
+// Text textures for the renderText helpers, cached by (font, colour, string).
+// A string of printable ASCII is composed from its font's atlas (see
+// FontManager) on the spot. Anything else goes through SDL_ttf, on a worker
+// thread with its own copies of the fonts (an SDL_ttf font must not be used
+// from two threads); the main thread only uploads the result. draw() waits a
+// little for a string it needs now (the line being typed), within a small
+// per-frame budget; past that, a string that isn't ready is drawn as a faint
+// bar, usually for a single frame. Textures unused for a few seconds go.
+// Without the worker, those strings are rasterized inline, still cached.
+class TextRasterizer {
+public:
+    struct Text {
+        SDL_Texture* texture = nullptr;
+        int w = 0;
+        int h = 0;
+    };
+
+    explicit TextRasterizer(FontManager& fonts) : fonts(fonts) {}
+    ~TextRasterizer();
+
+    bool start(); // The worker; it opens its copies of the fonts as jobs need them
+    void stop();
+    void close(); // Before the renderer goes
+
+    // Main thread, once per frame before rendering: upload what the worker
+    // finished and drop what hasn't been drawn for a while
+    void beginFrame(SDL_Renderer* renderer);
+
+    // Null while the worker is still on it; the first call queues it
+    const Text* get(SDL_Renderer* renderer, Font font, const std::string& text, SDL_Color color);
+    // Draws at (x, y), scaled about its middle, or centred on (x, y). Scaled
+    // text is drawn at its own (snapped) size, so it stays sharp. The
+    // placeholder takes its place until ready.
+    void draw(SDL_Renderer* renderer, Font font, const std::string& text, SDL_Color color,
+              int x, int y, float scale = 1.0f, bool centered = false);
+    // Uncached, on the calling (main) thread: for textures the caller keeps
+    SDL_Surface* render(Font font, const std::string& text, SDL_Color color);
+    void measure(Font font, const std::string& text, int* w, int* h);
+
+    void clear(); // Textures go before the renderer, and under memory pressure
+    size_t memoryUsage() const; // Texture bytes, estimated as 4 per pixel
+    size_t size() const { return entries.size(); }
+
+private:
+    static constexpr Uint32 EVICT_AFTER_FRAMES = 180; // About three seconds unused
+    static constexpr Uint32 SWEEP_INTERVAL_FRAMES = 60;
+    static constexpr double WAIT_BUDGET_MS = 3.0; // Per frame, across all draw() calls
+    static constexpr std::chrono::seconds WORKER_FONT_IDLE{10}; // The worker closes copies unused this long
+
+    using Key = std::tuple<Font, Uint32, std::string>; // Font, packed RGBA, text
+    struct Entry {
+        Text text;
+        bool pending = false;
+        Uint32 lastUsed = 0;
+    };
+    struct Job {
+        Key key;
+        SDL_Color color;
+    };
+    struct Result {
+        Key key;
+        SDL_Surface* surface;
+    };
+    struct WorkerFont {
+        TTF_Font* font = nullptr;
+        std::chrono::steady_clock::time_point lastUsed;
+    };
+
+    FontManager& fonts;
+    std::map<Key, Entry> entries;
+    Uint32 frame = 0;
+    double waitBudgetMs = WAIT_BUDGET_MS;
+
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    bool stopping = false;
+    std::deque<Job> jobs;
+    std::vector<Result> results;
+    std::map<Font, WorkerFont> workerFonts; // Worker thread only
+
+    void loop();
+    TTF_Font* workerFont(Font font);
+    void closeIdleWorkerFonts(bool all);
+    void collect(SDL_Renderer* renderer);
+    const Text* waitFor(SDL_Renderer* renderer, const Key& key);
+    void upload(SDL_Renderer* renderer, Entry& entry, SDL_Surface* surface);
+    void destroy(Entry& entry);
+    static Uint32 pack(SDL_Color color);
+};
@@ -0,0 +1,98 @@
+#include "Trace.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+// Written only by its own thread: the slot first, then a release of head.
+// Readers take head with acquire and copy behind it; no locks on the hot path.
+struct ThreadRing {
+    std::atomic<uint64_t> head{0};
+    Trace::Event events[Trace::RING_SIZE];
+    const char* threadName = "thread";
+    int tid = 0;
+};
+
+std::mutex registryMutex; // Taken once per thread, and by toJson()
+std::vector<std::unique_ptr<ThreadRing>> rings; // Never freed: a finished thread's events stay dumpable
+
+ThreadRing& localRing() {
+    thread_local ThreadRing* ring = nullptr;
+    if (!ring) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        rings.push_back(std::make_unique<ThreadRing>());
+        ring = rings.back().get();
+        ring->tid = static_cast<int>(rings.size());
+    }
+    return *ring;
+}
+
+void appendEscaped(std::ostringstream& out, const char* text) {
+    for (const char* p = text; *p; ++p) {
+        if (*p == '"' || *p == '\\') out << '\\';
+        if (static_cast<unsigned char>(*p) >= 0x20) out << *p;
+    }
+}
+
+} // namespace
+
+uint64_t Trace::nowUs() {
+    static const auto start = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+void Trace::record(const char* name, const char* category, uint64_t startUs, uint64_t endUs) {
+    ThreadRing& ring = localRing();
+    uint64_t head = ring.head.load(std::memory_order_relaxed);
+    ring.events[head % RING_SIZE] = {name, category, startUs, endUs - startUs};
+    ring.head.store(head + 1, std::memory_order_release);
+}
+
+void Trace::setThreadName(const char* name) {
+    localRing().threadName = name;
+}
+
+std::string Trace::toJson() {
+    std::ostringstream out;
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (const auto& ring : rings) {
+        out << (first ? "" : ",") << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << ring->tid
+            << ",\"args\":{\"name\":\"";
+        appendEscaped(out, ring->threadName);
+        out << "\"}}";
+        first = false;
+
+        // Keep clear of the slots the owner may be overwriting right now
+        uint64_t head = ring->head.load(std::memory_order_acquire);
+        uint64_t count = std::min<uint64_t>(head, RING_SIZE - 64);
+        for (uint64_t i = head - count; i < head; ++i) {
+            Event event = ring->events[i % RING_SIZE];
+            if (!event.name) continue;
+            out << ",{\"ph\":\"X\",\"name\":\"";
+            appendEscaped(out, event.name);
+            out << "\",\"cat\":\"";
+            appendEscaped(out, event.category ? event.category : "app");
+            out << "\",\"pid\":1,\"tid\":" << ring->tid << ",\"ts\":" << event.startUs
+                << ",\"dur\":" << event.durationUs << "}";
+        }
+    }
+    out << "]}";
+    return out.str();
+}
+
+bool Trace::dump(const std::string& path) {
+    std::string json = toJson();
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) return false;
+    file << json;
+    return static_cast<bool>(file);
+}
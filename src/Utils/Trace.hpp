@@ -0,0 +1,59 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+// Scoped timers for profiling on the device. Built with NOTEPAD_TRACING
+// (make TRACE=1) the macros record into a per-thread ring buffer; otherwise
+// they compile to nothing. Names and categories must be string literals (or
+// otherwise live forever): only the pointer is stored.
+//
+//   TRACE_SCOPE("EditorState::saveNote");
+//   TRACE_SCOPE_CAT("render", currentState->name());
+#ifdef NOTEPAD_TRACING
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name) Trace::Scope TRACE_CONCAT(traceScope, __LINE__)(name)
+#define TRACE_SCOPE_CAT(name, category) Trace::Scope TRACE_CONCAT(traceScope, __LINE__)(name, category)
+#define TRACE_THREAD(name) Trace::setThreadName(name)
+#else
+#define TRACE_SCOPE(name) ((void)0)
+#define TRACE_SCOPE_CAT(name, category) ((void)0)
+#define TRACE_THREAD(name) ((void)0)
+#endif
+
+class Trace {
+public:
+    // Per thread; the oldest events are overwritten
+    static constexpr uint32_t RING_SIZE = 8192;
+
+    struct Event {
+        const char* name;
+        const char* category;
+        uint64_t startUs;
+        uint64_t durationUs;
+    };
+
+    class Scope {
+    public:
+        explicit Scope(const char* name, const char* category = "app")
+            : name(name), category(category), startUs(nowUs()) {}
+        ~Scope() { record(name, category, startUs, nowUs()); }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        const char* name;
+        const char* category;
+        uint64_t startUs;
+    };
+
+    static uint64_t nowUs(); // Since the first call
+    static void record(const char* name, const char* category, uint64_t startUs, uint64_t endUs);
+    static void setThreadName(const char* name);
+
+    // Chrome trace-event JSON (chrome://tracing, ui.perfetto.dev) of every
+    // thread's ring. Safe to call while other threads keep recording: an
+    // event overwritten mid-copy can come out garbled, nothing worse.
+    static std::string toJson();
+    static bool dump(const std::string& path);
+};
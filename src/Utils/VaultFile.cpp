@@ -0,0 +1,146 @@
+#include "VaultFile.hpp"
+#include <filesystem>
+#include <cstring>
+
+namespace {
+
+const char kMagic[4] = {'N', 'P', 'V', '2'};
+const uint8_t kVersion = 1;
+const size_t kChunkOverhead = Crypto::NONCE_SIZE + Crypto::TAG_SIZE;
+
+void putU32(std::string& s, uint32_t v) {
+    for (int i = 0; i < 4; ++i) s += static_cast<char>(v >> (i * 8));
+}
+
+uint32_t getU32(const char* p) {
+    const uint8_t* u = reinterpret_cast<const uint8_t*>(p);
+    return uint32_t(u[0]) | (uint32_t(u[1]) << 8) | (uint32_t(u[2]) << 16) | (uint32_t(u[3]) << 24);
+}
+
+Crypto::Nonce freshNonce() {
+    std::string bytes = Crypto::randomBytes(Crypto::NONCE_SIZE);
+    Crypto::Nonce nonce;
+    std::memcpy(nonce.data(), bytes.data(), nonce.size());
+    return nonce;
+}
+
+// Parses the header; returns false if the file isn't in vault format.
+bool readHeader(std::istream& in, std::string& fileId, uint32_t& chunkSize) {
+    char header[VaultFile::HEADER_SIZE];
+    if (!in.read(header, sizeof(header))) return false;
+    if (std::memcmp(header, kMagic, 4) != 0 || static_cast<uint8_t>(header[4]) != kVersion) return false;
+    fileId.assign(header + 8, 16);
+    chunkSize = getU32(header + 24);
+    return chunkSize > 0;
+}
+
+} // namespace
+
+std::string VaultFile::chunkAad(const std::string& fileId, uint32_t index, bool final) {
+    std::string aad = fileId;
+    putU32(aad, index);
+    aad += static_cast<char>(final ? 1 : 0);
+    return aad;
+}
+
+bool VaultFile::isVaultFormat(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::string fileId;
+    uint32_t chunkSize;
+    return readHeader(in, fileId, chunkSize);
+}
+
+// --- Writer ---
+
+VaultFile::Writer::Writer(const std::string& path, const Crypto::Key& key)
+    : out(path, std::ios::binary | std::ios::trunc), key(key), fileId(Crypto::randomBytes(16)) {
+    std::string header(kMagic, 4);
+    header += static_cast<char>(kVersion);
+    header.append(3, '\0');
+    header += fileId;
+    putU32(header, CHUNK_SIZE);
+    out.write(header.data(), header.size());
+    ok = out.good();
+}
+
+void VaultFile::Writer::sealChunk(const char* data, size_t len, bool final) {
+    Crypto::Nonce nonce = freshNonce();
+    std::string aad = chunkAad(fileId, index++, final);
+    std::string body(data, len);
+    auto tag = Crypto::seal(key, nonce, reinterpret_cast<const uint8_t*>(aad.data()), aad.size(),
+                            reinterpret_cast<uint8_t*>(&body[0]), body.size());
+
+    out.write(reinterpret_cast<const char*>(nonce.data()), nonce.size());
+    out.write(body.data(), body.size());
+    out.write(reinterpret_cast<const char*>(tag.data()), tag.size());
+    if (!out.good()) ok = false;
+}
+
+bool VaultFile::Writer::write(const char* data, size_t len) {
+    pending.append(data, len);
+    // Always hold back at least one byte so the last full chunk can still be marked final
+    size_t offset = 0;
+    while (pending.size() - offset > CHUNK_SIZE) {
+        sealChunk(pending.data() + offset, CHUNK_SIZE, false);
+        offset += CHUNK_SIZE;
+    }
+    pending.erase(0, offset);
+    return ok;
+}
+
+bool VaultFile::Writer::finish() {
+    sealChunk(pending.data(), pending.size(), true);
+    pending.clear();
+    out.close();
+    return ok && !out.fail();
+}
+
+// --- Reader ---
+
+VaultFile::Reader::Reader(const std::string& path, const Crypto::Key& key)
+    : in(path, std::ios::binary), key(key) {
+    if (!readHeader(in, fileId, chunkSize)) {
+        error = true;
+        return;
+    }
+
+    std::error_code ec;
+    uint64_t size = std::filesystem::file_size(path, ec);
+    if (ec || size < HEADER_SIZE + kChunkOverhead) {
+        error = true;
+        return;
+    }
+    payloadSize = size - HEADER_SIZE;
+    uint64_t stride = chunkSize + kChunkOverhead;
+    chunkCount = static_cast<uint32_t>((payloadSize + stride - 1) / stride);
+    if (payloadSize - uint64_t(chunkCount - 1) * stride < kChunkOverhead) error = true;
+}
+
+bool VaultFile::Reader::next(std::string& plaintext) {
+    if (error || index >= chunkCount) return false;
+
+    uint64_t stride = chunkSize + kChunkOverhead;
+    bool final = (index == chunkCount - 1);
+    size_t recordSize = final ? static_cast<size_t>(payloadSize - uint64_t(index) * stride) : stride;
+
+    std::string record(recordSize, '\0');
+    if (!in.read(&record[0], recordSize)) {
+        error = true;
+        return false;
+    }
+
+    Crypto::Nonce nonce;
+    std::memcpy(nonce.data(), record.data(), nonce.size());
+    plaintext.assign(record, Crypto::NONCE_SIZE, recordSize - kChunkOverhead);
+    const uint8_t* tag = reinterpret_cast<const uint8_t*>(record.data()) + recordSize - Crypto::TAG_SIZE;
+
+    std::string aad = chunkAad(fileId, index, final);
+    if (!Crypto::open(key, nonce, reinterpret_cast<const uint8_t*>(aad.data()), aad.size(),
+                      reinterpret_cast<uint8_t*>(&plaintext[0]), plaintext.size(), tag)) {
+        plaintext.clear();
+        error = true;
+        return false;
+    }
+    index++;
+    return true;
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include "Crypto.hpp"
+#include <string>
+#include <fstream>
+#include <cstdint>
+
+// Chunked ChaCha20-Poly1305 container for vault notes.
+//
+//   header: "NPV2" | version u8 | reserved[3] | fileId[16] | chunkSize u32le
+//   chunk:  nonce[12] | ciphertext (chunkSize, last chunk shorter) | tag[16]
+//
+// Every chunk carries its own random nonce and is authenticated with
+// AAD = fileId | index u32le | final flag, so chunks can't be reordered,
+// moved between files or silently truncated.
+class VaultFile {
+public:
+    static constexpr uint32_t CHUNK_SIZE = 64 * 1024;
+    static constexpr size_t HEADER_SIZE = 28;
+
+    static bool isVaultFormat(const std::string& path);
+
+    // Streams plaintext into a new vault file, one sealed chunk at a time.
+    class Writer {
+    public:
+        Writer(const std::string& path, const Crypto::Key& key);
+        bool write(const char* data, size_t len);
+        bool finish();
+
+    private:
+        std::ofstream out;
+        Crypto::Key key;
+        std::string fileId;
+        std::string pending;
+        uint32_t index = 0;
+        bool ok = true;
+
+        void sealChunk(const char* data, size_t len, bool final);
+    };
+
+    // Decrypts a vault file progressively, one chunk per next() call.
+    class Reader {
+    public:
+        Reader(const std::string& path, const Crypto::Key& key);
+        // Returns false when no chunk is left or authentication failed (see failed()).
+        bool next(std::string& plaintext);
+        bool failed() const { return error; }
+
+    private:
+        std::ifstream in;
+        Crypto::Key key;
+        std::string fileId;
+        uint32_t chunkSize = CHUNK_SIZE;
+        uint32_t index = 0;
+        uint32_t chunkCount = 0;
+        uint64_t payloadSize = 0;
+        bool error = false;
+    };
+
+private:
+    static std::string chunkAad(const std::string& fileId, uint32_t index, bool final);
+};
@@ -0,0 +1,106 @@
+#include "VaultManifest.hpp"
+#include "NoteFormat.hpp"
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+static const std::string kManifestMagic = "NPM1";
+
+// Record layout (tab separated): <vault name> <original name> <size> <mtime> <preview>
+// Original names can hold any character but NUL, so tab, newline and
+// backslash in them are written as \t, \n and \\.
+
+namespace {
+
+std::string escapeName(const std::string& name) {
+    std::string out;
+    for (char c : name) {
+        if (c == '\\') out += "\\\\";
+        else if (c == '\t') out += "\\t";
+        else if (c == '\n') out += "\\n";
+        else out += c;
+    }
+    return out;
+}
+
+std::string unescapeName(const std::string& field) {
+    std::string out;
+    for (size_t i = 0; i < field.size(); ++i) {
+        if (field[i] != '\\' || i + 1 == field.size()) {
+            out += field[i];
+            continue;
+        }
+        char c = field[++i];
+        out += c == 't' ? '\t' : c == 'n' ? '\n' : c;
+    }
+    return out;
+}
+
+// The whole field must be a number; a damaged record is skipped, not trusted
+bool parseNumber(const std::string& field, long long min, long long max, long long& value) {
+    if (field.empty()) return false;
+    char* end = nullptr;
+    errno = 0;
+    value = std::strtoll(field.c_str(), &end, 10);
+    return errno == 0 && *end == '\0' && value >= min && value <= max;
+}
+
+} // namespace
+
+void VaultManifest::parse(const std::string& plaintext) {
+    entries.clear();
+    std::istringstream stream(plaintext);
+    std::string record;
+    if (!std::getline(stream, record) || record != kManifestMagic) return;
+
+    while (std::getline(stream, record)) {
+        std::vector<std::string> fields;
+        std::stringstream ss(record);
+        std::string field;
+        while (std::getline(ss, field, '\t')) fields.push_back(field);
+        long long size = 0;
+        long long modified = 0;
+        if (fields.size() < 4 || fields[0].empty() || !parseNumber(fields[2], 0, LLONG_MAX, size) ||
+            !parseNumber(fields[3], LLONG_MIN, LLONG_MAX, modified)) {
+            std::cerr << "Vault manifest: skipped a damaged record" << std::endl;
+            continue;
+        }
+
+        ManifestEntry entry;
+        entry.originalName = unescapeName(fields[1]);
+        entry.size = static_cast<uintmax_t>(size);
+        entry.modified = static_cast<std::time_t>(modified);
+        entry.preview = fields.size() > 4 ? fields[4] : "";
+        entries[fields[0]] = entry;
+    }
+}
+
+std::string VaultManifest::serialize() const {
+    std::string out = kManifestMagic + "\n";
+    for (const auto& [vaultName, entry] : entries) {
+        out += vaultName + "\t" + escapeName(entry.originalName) + "\t" + std::to_string(entry.size) + "\t" +
+               std::to_string(static_cast<long long>(entry.modified)) + "\t" + entry.preview + "\n";
+    }
+    return out;
+}
+
+const ManifestEntry* VaultManifest::find(const std::string& vaultName) const {
+    auto it = entries.find(vaultName);
+    return it == entries.end() ? nullptr : &it->second;
+}
+
+std::string VaultManifest::makePreview(const std::string& content) {
+    // Only the head of the note is needed
+    for (const Line& line : NoteFormat::parse(content.substr(0, 512))) {
+        if (line.content.empty()) continue;
+        std::string preview = line.content.substr(0, PREVIEW_LENGTH);
+        for (char& c : preview) {
+            if (c == '\t' || c == '\r' || c == '\n') c = ' ';
+        }
+        return preview;
+    }
+    return "";
+}
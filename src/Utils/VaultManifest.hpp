@@ -0,0 +1,35 @@
+#pragma once
+#include <string>
+#include <map>
+#include <ctime>
+#include <cstdint>
+
+struct ManifestEntry {
+    std::string originalName;
+    uintmax_t size = 0; // Plaintext bytes
+    std::time_t modified = 0;
+    std::string preview;
+};
+
+// Maps randomized vault file names back to their original metadata so the
+// browser can list and sort the vault without decrypting every file.
+// Stored encrypted as .sys_cache/.manifest (see FileSystem).
+class VaultManifest {
+public:
+    static constexpr size_t PREVIEW_LENGTH = 48;
+
+    void parse(const std::string& plaintext);
+    std::string serialize() const;
+
+    void set(const std::string& vaultName, const ManifestEntry& entry) { entries[vaultName] = entry; }
+    void remove(const std::string& vaultName) { entries.erase(vaultName); }
+    void clear() { entries.clear(); }
+    const ManifestEntry* find(const std::string& vaultName) const;
+    const std::map<std::string, ManifestEntry>& all() const { return entries; }
+
+    // First non-empty line of a note, without bullet syntax, truncated for display.
+    static std::string makePreview(const std::string& content);
+
+private:
+    std::map<std::string, ManifestEntry> entries;
+};
@@ -1,7 +1,21 @@
 #include "App.hpp"
+#include <cstring>
 
 int main(int argc, char* argv[]) {
     App app;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--bench-startup") == 0) app.setStartupBenchmark(true);
+        else if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc) app.setRecordPath(argv[++i]);
+        else if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc) app.setReplayPath(argv[++i]);
+        else if (std::strcmp(argv[i], "--max-speed") == 0) app.setMaxSpeed(true);
+        else if (std::strcmp(argv[i], "--headless") == 0) app.setHeadless(true);
+        else if (std::strcmp(argv[i], "--latency") == 0) app.setLatencyMeasurement(true);
+        else if (std::strcmp(argv[i], "--simulate-pressure") == 0 && i + 1 < argc) {
+            ++i;
+            if (std::strcmp(argv[i], "low") == 0) app.simulateMemoryPressure(MemoryPressure::LOW);
+            else if (std::strcmp(argv[i], "critical") == 0) app.simulateMemoryPressure(MemoryPressure::CRITICAL);
+        }
+    }
     if (app.init()) {
         app.run();
     }
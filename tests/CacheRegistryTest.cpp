@@ -0,0 +1,90 @@
+#include "Test.hpp"
+#include "../src/Utils/CacheRegistry.hpp"
+#include <vector>
+
+namespace {
+
+SystemSample sample(long availablePercent, float stallPercent = -1.0f) {
+    SystemSample s;
+    s.memTotalKB = 100000;
+    s.memAvailableKB = availablePercent * 1000;
+    s.memoryStallPercent = stallPercent;
+    return s;
+}
+
+// A fake cache that releases `kb` every time and notes the order it was evicted in
+void addCache(CacheRegistry& caches, std::vector<std::string>& evicted, const std::string& name,
+              int priority, MemoryPressure firstStage, size_t kb) {
+    caches.add(name, priority, firstStage, [kb]() { return kb * 1024; },
+               [&evicted, name, kb](MemoryPressure level) {
+                   evicted.push_back(name);
+                   return kb * 1024;
+               });
+}
+
+} // namespace
+
+void testCacheRegistry() {
+    Test::run("cache.levels", []() {
+        using P = MemoryPressure;
+        CHECK(CacheRegistry::levelOf(sample(50)) == P::NONE);
+        CHECK(CacheRegistry::levelOf(sample(14)) == P::LOW);
+        CHECK(CacheRegistry::levelOf(sample(6)) == P::CRITICAL);
+        CHECK(CacheRegistry::levelOf(SystemSample()) == P::NONE); // No readings
+        CHECK(CacheRegistry::levelOf(sample(50, 12.0f)) == P::LOW);
+        CHECK(CacheRegistry::levelOf(sample(50, 45.0f)) == P::CRITICAL);
+
+        // Hysteresis: a level holds until the sample clears its threshold by the margin
+        CHECK(CacheRegistry::levelOf(sample(16), P::NONE) == P::NONE);
+        CHECK(CacheRegistry::levelOf(sample(16), P::LOW) == P::LOW);
+        CHECK(CacheRegistry::levelOf(sample(19), P::LOW) == P::NONE);
+        CHECK(CacheRegistry::levelOf(sample(8), P::CRITICAL) == P::CRITICAL);
+        CHECK(CacheRegistry::levelOf(sample(8), P::LOW) == P::LOW);
+        CHECK(CacheRegistry::levelOf(sample(50, 7.0f), P::LOW) == P::LOW);
+        CHECK(CacheRegistry::levelOf(sample(50, 4.0f), P::LOW) == P::NONE);
+
+        // Back past 18% available: 10% short of 100 MB is 8 MB
+        CHECK(CacheRegistry::shortfallOf(sample(10)) == 8000 * 1024);
+        CHECK(CacheRegistry::shortfallOf(sample(50)) == 0);
+        CHECK(CacheRegistry::shortfallOf(SystemSample()) == 0);
+    });
+
+    Test::run("cache.stages", []() {
+        using P = MemoryPressure;
+        CacheRegistry caches;
+        std::vector<std::string> evicted;
+        addCache(caches, evicted, "documents", 1, P::LOW, 200);
+        addCache(caches, evicted, "textures", 0, P::LOW, 100);
+        addCache(caches, evicted, "fonts", 0, P::LOW, 50);
+        addCache(caches, evicted, "undo", 3, P::CRITICAL, 1000);
+        caches.add("listing", 10, P::CRITICAL, []() { return size_t(4096); }); // Counted only
+
+        // The cheapest priority covers 120 KB, so nothing above it goes
+        CHECK(caches.evict(P::LOW, 120 * 1024, 0) == 150 * 1024);
+        CHECK((evicted == std::vector<std::string>{"textures", "fonts"}));
+
+        // They are refilling: the next pass starts a priority up and stops below
+        // the critical stage even though the shortfall isn't covered
+        evicted.clear();
+        CHECK(caches.evict(P::LOW, 300 * 1024, 1000) == 200 * 1024);
+        CHECK((evicted == std::vector<std::string>{"documents"}));
+
+        // Everything due at low was just evicted
+        evicted.clear();
+        CHECK(caches.evict(P::LOW, 0, 2000) == 0);
+        CHECK(evicted.empty());
+
+        // Going critical doesn't wait for a cool-down that started at low
+        evicted.clear();
+        CHECK(caches.evict(P::CRITICAL, 2000 * 1024, 3000) == 1350 * 1024);
+        CHECK((evicted == std::vector<std::string>{"textures", "fonts", "documents", "undo"}));
+
+        // Unknown shortfall: only the first priority that releases anything
+        evicted.clear();
+        CHECK(caches.evict(P::LOW, 0, 3000 + CacheRegistry::EVICT_COOLDOWN_MS) == 150 * 1024);
+        CHECK((evicted == std::vector<std::string>{"textures", "fonts"}));
+
+        CHECK(caches.evict(P::NONE, 1 << 30, 60000) == 0);
+        CHECK(caches.totalCost() == 1350 * 1024 + 4096);
+    });
+}
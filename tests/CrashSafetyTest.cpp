@@ -0,0 +1,163 @@
+#include "Test.hpp"
+#include "SyscallShim.hpp"
+#include "../src/Utils/FileSystem.hpp"
+#include <filesystem>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+namespace fs = std::filesystem;
+
+const std::string PASSPHRASE = "crash test";
+const std::string OLD_CONTENT = "* Old version\n- kept until the new one is complete\n";
+const std::string NEW_CONTENT = "* New version\n! longer than the old one, so a torn write would show\n- " + std::string(3000, 'x') + "\n";
+
+// Runs op in a child that is killed right after its step-th call. True if it
+// was killed; false if op finished in fewer steps.
+bool crashAfter(int step, const std::function<void()>& op) {
+    pid_t pid = fork();
+    if (pid == 0) {
+        SyscallShim::killAfter(step);
+        op();
+        SyscallShim::killAfter(0);
+        _exit(0);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return WIFSIGNALED(status) && WTERMSIG(status) == SIGKILL;
+}
+
+int tempFiles() {
+    int count = 0;
+    for (const std::string& dir : {std::string("Notes/Public/"), std::string(".sys_cache/")}) {
+        for (const auto& entry : fs::directory_iterator(dir)) {
+            std::string name = entry.path().filename().string();
+            if (name[0] == '.' && entry.path().extension() == ".tmp") count++;
+        }
+    }
+    return count;
+}
+
+void reset() {
+    FileSystem::lockVault();
+    fs::remove_all("Notes");
+    fs::remove_all(".sys_cache");
+    FileSystem::init();
+    FileSystem::setCompression(false);
+}
+
+// What the next launch does before anything else
+void restart() {
+    FileSystem::lockVault();
+    FileSystem::removeStaleTemps();
+    CHECK(tempFiles() == 0);
+}
+
+// Crashes op after every step in turn; after each crash (and once after a run
+// that got to the end) verify(finished) inspects what a restart finds. Returns
+// the number of steps op took.
+int crashEverywhere(const std::function<void()>& setup, const std::function<void()>& op,
+                    const std::function<void(bool finished)>& verify) {
+    for (int step = 1; step < 10000; ++step) {
+        setup();
+        bool crashed = crashAfter(step, op);
+        restart();
+        verify(!crashed);
+        if (!crashed) return step - 1;
+    }
+    CHECK(!"op never finished");
+    return 0;
+}
+
+void checkSave(bool compressed) {
+    int steps = crashEverywhere(
+        [&]() {
+            reset();
+            FileSystem::saveFile("note.txt", OLD_CONTENT, false);
+            FileSystem::setCompression(compressed);
+        },
+        []() { FileSystem::saveFile("note.txt", NEW_CONTENT, false); },
+        [](bool finished) {
+            std::string content;
+            CHECK(FileSystem::readFile("note.txt", false, content));
+            CHECK(content == NEW_CONTENT || (!finished && content == OLD_CONTENT));
+        });
+    // open, write, fsync, rename, then open and fsync the directory: the shim must have seen them all
+    CHECK(steps >= 6);
+}
+
+} // namespace
+
+// A note is saved, saved again and privatized while the process is killed
+// after every open, write, fsync and rename in turn. Whatever the step, the
+// old or the new version survives whole, and the next launch's temp cleanup
+// leaves nothing behind. (SIGKILL keeps the page cache: this covers the
+// ordering of the steps, not a power cut.)
+void testCrashSafety() {
+    Test::run("crash.save", []() { checkSave(false); });
+    Test::run("crash.save.compressed", []() { checkSave(true); });
+
+    Test::run("crash.save.vault", []() {
+        int steps = crashEverywhere(
+            []() {
+                reset();
+                FileSystem::unlockVault(PASSPHRASE);
+                FileSystem::saveFile("0xabc.dat", OLD_CONTENT, true);
+            },
+            []() { FileSystem::saveFile("0xabc.dat", NEW_CONTENT, true); },
+            [](bool finished) {
+                CHECK(FileSystem::unlockVault(PASSPHRASE)); // The manifest still authenticates
+                std::string content;
+                CHECK(FileSystem::readFile("0xabc.dat", true, content));
+                CHECK(content == NEW_CONTENT || (!finished && content == OLD_CONTENT));
+                CHECK(FileSystem::listVaultFiles().size() == 1);
+            });
+        CHECK(steps >= 6);
+    });
+
+    Test::run("crash.privatize", []() {
+        int steps = crashEverywhere(
+            []() {
+                reset();
+                FileSystem::unlockVault(PASSPHRASE);
+                FileSystem::saveFile("secret.txt", OLD_CONTENT, false);
+            },
+            []() { FileSystem::privatizeFile("secret.txt"); },
+            [](bool finished) {
+                CHECK(FileSystem::unlockVault(PASSPHRASE));
+                // Public or in the vault, never neither; unlocking finishes a
+                // privatize that was killed with both copies on the card
+                int copies = 0;
+                std::string content;
+                bool isPublic = FileSystem::readFile("secret.txt", false, content) && content == OLD_CONTENT;
+                if (isPublic) copies++;
+                for (const FileEntry& entry : FileSystem::listVaultFiles()) {
+                    if (FileSystem::readFile(entry.name, true, content) && content == OLD_CONTENT) copies++;
+                }
+                CHECK(copies == 1);
+                CHECK(FileSystem::listVaultFiles().size() == (isPublic ? 0u : 1u));
+                if (finished) CHECK(!isPublic);
+            });
+        CHECK(steps >= 6);
+    });
+
+    // A compressed note cut short on the card must not be sealed half-read and then deleted
+    Test::run("crash.privatize.truncated", []() {
+        reset();
+        CHECK(FileSystem::unlockVault(PASSPHRASE));
+        FileSystem::setCompression(true);
+        FileSystem::saveFile("cut.txt", NEW_CONTENT, false);
+        std::string path = FileSystem::publicDirectory() + "cut.txt";
+        fs::resize_file(path, fs::file_size(path) / 2);
+        uintmax_t size = fs::file_size(path);
+
+        CHECK(!FileSystem::privatizeFile("cut.txt"));
+        CHECK(fs::exists(path) && fs::file_size(path) == size);
+        CHECK(FileSystem::listVaultFiles().empty());
+        restart();
+        CHECK(FileSystem::unlockVault(PASSPHRASE));
+        CHECK(FileSystem::listVaultFiles().empty());
+    });
+}
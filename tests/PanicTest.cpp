@@ -0,0 +1,58 @@
+#include "Test.hpp"
+#include "../src/App.hpp"
+#include "../src/Utils/InputRecording.hpp"
+#include <filesystem>
+#include <utility>
+
+namespace {
+
+namespace fs = std::filesystem;
+
+void recordKey(InputRecorder& recorder, uint32_t frame, Uint32 type, SDL_Scancode scancode, SDL_Keycode sym) {
+    SDL_Event event;
+    SDL_memset(&event, 0, sizeof(event));
+    event.type = type;
+    event.key.keysym.scancode = scancode;
+    event.key.keysym.sym = sym;
+    event.key.state = type == SDL_KEYDOWN ? SDL_PRESSED : SDL_RELEASED;
+    recorder.record(frame, frame * 16, event);
+}
+
+} // namespace
+
+// The panic combo replayed headless, as --headless --max-speed --replay runs
+// it: the decoy must be presented while the combo's event is being handled,
+// not by the frame that follows
+void testPanic() {
+    Test::run("panic.replay", []() {
+        fs::path fonts = fs::path(Test::rootDirectory()) / "assets" / "fonts";
+        if (!fs::exists(fonts / "default.ttf")) {
+            Test::skip("assets/fonts/default.ttf not found");
+            return;
+        }
+        fs::create_directories("assets");
+        fs::create_directory_symlink(fonts, "assets/fonts");
+
+        // L2 + R2 + SELECT held, then START
+        const std::pair<SDL_Scancode, SDL_Keycode> combo[] = {
+            {SDL_SCANCODE_K, SDLK_k}, {SDL_SCANCODE_L, SDLK_l},
+            {SDL_SCANCODE_LSHIFT, SDLK_LSHIFT}, {SDL_SCANCODE_RETURN, SDLK_RETURN}};
+        InputRecorder recorder;
+        CHECK(recorder.open("panic.npe"));
+        for (const auto& [scancode, sym] : combo) recordKey(recorder, 2, SDL_KEYDOWN, scancode, sym);
+        for (const auto& [scancode, sym] : combo) recordKey(recorder, 4, SDL_KEYUP, scancode, sym);
+        recorder.close();
+
+        App app;
+        app.setHeadless(true);
+        app.setMaxSpeed(true);
+        app.setReplayPath("panic.npe");
+        if (!app.init()) {
+            Test::skip("no SDL video driver");
+            return;
+        }
+        app.run(); // Prints the {"panic":..} line with the latency
+        CHECK(app.getPanicLatency().size() == 1);
+        CHECK(app.getDeferredPanics() == 0);
+    });
+}
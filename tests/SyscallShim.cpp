@@ -0,0 +1,78 @@
+#include "SyscallShim.hpp"
+#include <cstdarg>
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+namespace {
+
+int killStep = 0;
+int stepCount = 0;
+
+template <typename F>
+F real(const char* name) {
+    static_assert(sizeof(F) == sizeof(void*), "function pointer");
+    void* symbol = dlsym(RTLD_NEXT, name);
+    F function;
+    __builtin_memcpy(&function, &symbol, sizeof(function));
+    return function;
+}
+
+void step() {
+    if (killStep == 0) return;
+    if (++stepCount == killStep) ::kill(::getpid(), SIGKILL);
+}
+
+} // namespace
+
+void SyscallShim::killAfter(int step) {
+    killStep = step;
+    stepCount = 0;
+}
+
+int SyscallShim::steps() {
+    return stepCount;
+}
+
+// Same names as libc's: the executable's definitions win over libc's for every
+// caller, the app code, libstdc++ and std::filesystem included
+extern "C" {
+
+int open(const char* path, int flags, ...) {
+    static auto next = real<int (*)(const char*, int, ...)>("open");
+    mode_t mode = 0;
+    if (flags & (O_CREAT | O_TMPFILE)) {
+        va_list args;
+        va_start(args, flags);
+        mode = va_arg(args, mode_t);
+        va_end(args);
+    }
+    int fd = next(path, flags, mode);
+    step();
+    return fd;
+}
+
+ssize_t write(int fd, const void* data, size_t size) {
+    static auto next = real<ssize_t (*)(int, const void*, size_t)>("write");
+    ssize_t written = next(fd, data, size);
+    step();
+    return written;
+}
+
+int fsync(int fd) {
+    static auto next = real<int (*)(int)>("fsync");
+    int result = next(fd);
+    step();
+    return result;
+}
+
+int rename(const char* from, const char* to) {
+    static auto next = real<int (*)(const char*, const char*)>("rename");
+    int result = next(from, to);
+    step();
+    return result;
+}
+
+} // extern "C"
@@ -0,0 +1,13 @@
+#pragma once
+
+// Kill-at-step shim for crash tests. The test binary interposes open, write,
+// fsync and rename (directory fsyncs included); once armed, the process
+// SIGKILLs itself right after the given call returns. Arm it only in a forked
+// child: killAfter(n) for n = 1, 2, ... crashes at every step of an operation
+// in turn, until the operation finishes within n steps.
+namespace SyscallShim {
+
+void killAfter(int step); // 0 disarms
+int steps();              // Calls since last armed
+
+} // namespace SyscallShim
@@ -0,0 +1,63 @@
+#include "Test.hpp"
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <unistd.h>
+
+std::string Test::nameFilter;
+std::string Test::scratch;
+std::string Test::root;
+std::string Test::skipReason;
+int Test::failed = 0;
+int Test::caseFailures = 0;
+std::ostream* Test::output = &std::cout;
+
+bool Test::enabled(const std::string& name) {
+    return nameFilter.empty() || name.find(nameFilter) != std::string::npos;
+}
+
+void Test::run(const std::string& name, const std::function<void()>& body) {
+    if (!enabled(name)) return;
+    namespace fs = std::filesystem;
+    fs::path root = fs::current_path();
+    fs::path directory = fs::temp_directory_path() / ("notepad_tests_" + std::to_string(getpid()));
+    fs::remove_all(directory);
+    fs::create_directories(directory);
+    fs::current_path(directory);
+    scratch = directory.string();
+
+    caseFailures = 0;
+    skipReason.clear();
+    body();
+    if (caseFailures > 0) failed++;
+    if (caseFailures == 0 && !skipReason.empty()) *output << "skip " << name << " (" << skipReason << ")" << std::endl;
+    else *output << (caseFailures > 0 ? "FAIL " : "ok   ") << name << std::endl;
+
+    fs::current_path(root);
+    fs::remove_all(directory);
+}
+
+void Test::check(bool ok, const char* expression, const char* file, int line) {
+    if (ok) return;
+    caseFailures++;
+    std::cerr << "  " << file << ":" << line << ": CHECK(" << expression << ") failed" << std::endl;
+}
+
+// notepad_tests [name filter]
+int main(int argc, char* argv[]) {
+    if (argc > 1) Test::setFilter(argv[1]);
+    Test::setRootDirectory(std::filesystem::current_path().string());
+    // The code under test logs to std::cout; stdout carries nothing but results
+    std::ostream results(std::cout.rdbuf());
+    std::cout.rdbuf(std::cerr.rdbuf());
+    Test::setOutput(results);
+
+    testCrashSafety();
+    testCacheRegistry();
+    testVaultManifest();
+    testPanic();
+
+    std::cout.rdbuf(results.rdbuf());
+    if (Test::failedCases() > 0) std::cout << Test::failedCases() << " failed" << std::endl;
+    return Test::failedCases() > 0 ? 1 : 0;
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <functional>
+#include <ostream>
+#include <string>
+
+// Harness for notepad_tests. A case runs its checks to the end; CHECK only
+// records a failure (with where it happened) so one run reports everything
+// that is broken. One line per case on stdout; the exit code is non-zero if
+// any case failed.
+class Test {
+public:
+    static void setFilter(const std::string& filter) { nameFilter = filter; }
+    static void setOutput(std::ostream& stream) { output = &stream; }
+    static bool enabled(const std::string& name);
+    static void run(const std::string& name, const std::function<void()>& body);
+    static void check(bool ok, const char* expression, const char* file, int line);
+    // Ends the current case as skipped (the body should return right after)
+    static void skip(const std::string& reason) { skipReason = reason; }
+    static int failedCases() { return failed; }
+
+    // Where notepad_tests was started: the source tree, for assets
+    static void setRootDirectory(const std::string& directory) { root = directory; }
+    static const std::string& rootDirectory() { return root; }
+
+    // Every case gets an empty directory of its own as the working directory,
+    // so FileSystem's relative paths never reach real notes
+    static std::string scratchDirectory() { return scratch; }
+
+private:
+    static std::string nameFilter;
+    static std::string scratch;
+    static std::string root;
+    static std::string skipReason;
+    static int failed;
+    static int caseFailures;
+    static std::ostream* output;
+};
+
+#define CHECK(expression) Test::check((expression), #expression, __FILE__, __LINE__)
+
+// One function per area, each in its own file
+void testCrashSafety();
+void testCacheRegistry();
+void testVaultManifest();
+void testPanic();
@@ -0,0 +1,31 @@
+#include "Test.hpp"
+#include "../src/Utils/VaultManifest.hpp"
+
+void testVaultManifest() {
+    // Any name a public note can have survives the round trip
+    Test::run("manifest.names", []() {
+        VaultManifest manifest;
+        for (const std::string name : {"a\tb.txt", "line\nbreak.txt", "back\\slash.txt", "trailing\\"}) {
+            ManifestEntry entry;
+            entry.originalName = name;
+            entry.size = 42;
+            entry.modified = 1700000000;
+            manifest.set("0x" + std::to_string(name.size()) + ".dat", entry);
+        }
+        VaultManifest loaded;
+        loaded.parse(manifest.serialize());
+        CHECK(loaded.all().size() == manifest.all().size());
+        for (const auto& [vaultName, entry] : manifest.all()) {
+            const ManifestEntry* found = loaded.find(vaultName);
+            CHECK(found && found->originalName == entry.originalName && found->size == 42);
+        }
+    });
+
+    // A damaged record is dropped; the rest still load
+    Test::run("manifest.damaged", []() {
+        VaultManifest manifest;
+        manifest.parse("NPM1\n0x1.dat\tgood.txt\t10\t5\tpreview\n0x2.dat\tbad.txt\t\t5\n0x3.dat\tbad.txt\t1x\t5\n0x4.dat\tshort\n");
+        CHECK(manifest.all().size() == 1);
+        CHECK(manifest.find("0x1.dat") && manifest.find("0x1.dat")->preview == "preview");
+    });
+}
@@ -0,0 +1,76 @@
+// Build step (make fonts): pre-rasterizes printable ASCII of each font at the
+// sizes the app draws at into one file read by BakedFont. The glyphs are baked
+// by the same code that builds other sizes at run time (BakedFont::Face::bake).
+// Runs on the build machine; the output is the same for every target.
+//
+// Usage: bake_fonts <out.npf> <font.ttf>:<size> [<font.ttf>:<size> ...]
+
+#include "../src/Utils/BakedFont.hpp"
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+namespace {
+
+std::string stem(const std::string& path) {
+    size_t slash = path.find_last_of("/\\");
+    std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+    size_t dot = name.rfind('.');
+    return dot == std::string::npos ? name : name.substr(0, dot);
+}
+
+bool bakeFace(const std::string& path, int size, BakedFont& fonts) {
+    TTF_Font* font = TTF_OpenFont(path.c_str(), size);
+    if (!font) {
+        std::cerr << "bake_fonts: can't open " << path << ": " << TTF_GetError() << std::endl;
+        return false;
+    }
+    BakedFont::Face face = BakedFont::Face::empty(stem(path), size, font);
+    for (unsigned char c = BakedFont::FIRST_GLYPH; c <= BakedFont::LAST_GLYPH; ++c) {
+        if (!face.bake(font, c)) std::cerr << "bake_fonts: " << path << " has no glyph for '" << c << "'" << std::endl;
+    }
+    TTF_CloseFont(font);
+
+    std::cout << "bake_fonts: " << face.name << " " << size << "px, " << face.atlasWidth << "x" << face.atlasHeight
+              << " atlas" << std::endl;
+    fonts.add(std::move(face));
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: bake_fonts <out.npf> <font.ttf>:<size> ..." << std::endl;
+        return 2;
+    }
+    if (TTF_Init() == -1) {
+        std::cerr << "bake_fonts: TTF_Init failed: " << TTF_GetError() << std::endl;
+        return 1;
+    }
+
+    BakedFont fonts;
+    for (int i = 2; i < argc; ++i) {
+        std::string spec = argv[i];
+        size_t colon = spec.rfind(':');
+        int size = colon == std::string::npos ? 0 : std::atoi(spec.c_str() + colon + 1);
+        if (size <= 0) {
+            std::cerr << "bake_fonts: expected <font.ttf>:<size>, got " << spec << std::endl;
+            TTF_Quit();
+            return 2;
+        }
+        if (!bakeFace(spec.substr(0, colon), size, fonts)) {
+            TTF_Quit();
+            return 1;
+        }
+    }
+    TTF_Quit();
+
+    if (!fonts.save(argv[1])) {
+        std::cerr << "bake_fonts: can't write " << argv[1] << std::endl;
+        return 1;
+    }
+    return 0;
+}